@@ -0,0 +1,118 @@
+include_guard()
+
+# Converts the PNGs in assets/ into pre-decoded RGBA32 textures in the build dir and embeds them next to mmkay's
+# assets, with a registry that maps each PNG asset to its texture (GetPredecodedAssets in sprite_cache.hpp).
+# See tools/png2rgba for the format. Images that would decode to more than PREDECODE_MAX_BYTES are only embedded as PNG.
+set(PREDECODE_MAX_BYTES 1048576 CACHE STRING "Largest decoded size, in bytes, of an embedded pre-decoded image")
+
+set(PREDECODED_ASSETS_DIR ${CMAKE_BINARY_DIR}/predecoded-assets)
+set(PNG2RGBA_BUILD_DIR ${CMAKE_BINARY_DIR}/host-tools/png2rgba)
+set(PNG2RGBA ${PNG2RGBA_BUILD_DIR}/png2rgba${CMAKE_HOST_EXECUTABLE_SUFFIX})
+
+# The tool runs on the build machine, so it is built as its own project with the host compiler
+execute_process(
+        COMMAND ${CMAKE_COMMAND} -S ${CMAKE_CURRENT_SOURCE_DIR}/tools/png2rgba -B ${PNG2RGBA_BUILD_DIR} -DCMAKE_BUILD_TYPE=Release
+        RESULT_VARIABLE png2rgba_result
+        OUTPUT_QUIET
+)
+if(png2rgba_result EQUAL 0)
+        execute_process(
+                COMMAND ${CMAKE_COMMAND} --build ${PNG2RGBA_BUILD_DIR}
+                RESULT_VARIABLE png2rgba_result
+                OUTPUT_QUIET
+        )
+endif()
+
+set(predecoded_asm "")
+set(predecoded_externs "")
+set(predecoded_entries "")
+set(predecoded_textures "")
+
+if(NOT png2rgba_result EQUAL 0)
+        message(WARNING "Could not build png2rgba for the host, images will only be embedded as PNG")
+        set(png_asset_list "")
+else()
+        FILE(GLOB_RECURSE png_asset_list RELATIVE ${CMAKE_CURRENT_SOURCE_DIR}/assets ${CMAKE_CURRENT_SOURCE_DIR}/assets/*.png)
+endif()
+
+FOREACH(png_asset ${png_asset_list})
+        set(png_file ${CMAKE_CURRENT_SOURCE_DIR}/assets/${png_asset})
+        string(REGEX REPLACE "\\.png$" ".rgba" rgba_file ${PREDECODED_ASSETS_DIR}/${png_asset})
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${png_file})
+
+        if(NOT EXISTS ${rgba_file} OR ${png_file} IS_NEWER_THAN ${rgba_file} OR ${PNG2RGBA} IS_NEWER_THAN ${rgba_file})
+                get_filename_component(rgba_dir ${rgba_file} DIRECTORY)
+                file(MAKE_DIRECTORY ${rgba_dir})
+                execute_process(
+                        COMMAND ${PNG2RGBA} ${png_file} ${rgba_file} ${PREDECODE_MAX_BYTES}
+                        RESULT_VARIABLE convert_result
+                        ERROR_VARIABLE convert_error
+                        ERROR_STRIP_TRAILING_WHITESPACE
+                )
+                if(convert_result EQUAL 2)
+                        message(STATUS "Embedding as PNG only, ${convert_error}")
+                        file(REMOVE ${rgba_file})
+                        continue()
+                elseif(NOT convert_result EQUAL 0)
+                        message(WARNING "Failed to pre-decode ${convert_error}")
+                        file(REMOVE ${rgba_file})
+                        continue()
+                endif()
+        endif()
+
+        # The names mmkay gives the asset: ModList/frame.png is IncludedAssets::ModList::frame_png
+        get_filename_component(asset_dir ${png_asset} DIRECTORY)
+        get_filename_component(asset_name ${png_asset} NAME)
+        string(MAKE_C_IDENTIFIER ${asset_name} asset_name)
+        string(MAKE_C_IDENTIFIER ${png_asset} symbol)
+        set(asset IncludedAssets)
+        if(asset_dir)
+                string(REPLACE "/" "::" asset_namespace ${asset_dir})
+                string(APPEND asset "::${asset_namespace}")
+        endif()
+        string(APPEND asset "::${asset_name}")
+
+        # The RTEX header, then the pixels as an il2cpp array: the 32 byte array header IncludedAsset fills in, the
+        # pixels, and the byte IncludedAsset overwrites with a terminator
+        set(start _predecoded_${symbol}_start)
+        set(end _predecoded_${symbol}_end)
+        string(APPEND predecoded_asm
+                "    \".balign 16\\n\"\n"
+                "    \".globl ${start}\\n.hidden ${start}\\n${start}:\\n\"\n"
+                "    \".incbin \\\"${rgba_file}\\\", 0, 16\\n\"\n"
+                "    \".space 32\\n\"\n"
+                "    \".incbin \\\"${rgba_file}\\\", 16\\n\"\n"
+                "    \".byte 0\\n\"\n"
+                "    \".globl ${end}\\n.hidden ${end}\\n${end}:\\n\"\n"
+        )
+        string(APPEND predecoded_externs "extern \"C\" uint8_t ${start}[];\nextern \"C\" uint8_t ${end}[];\n")
+        string(APPEND predecoded_entries
+                "    {${asset}, *reinterpret_cast<RawTextureHeader const*>(${start}), IncludedAsset(${start} + sizeof(RawTextureHeader), ${end})},\n"
+        )
+        list(APPEND predecoded_textures ${rgba_file})
+ENDFOREACH()
+
+set(predecoded_source "// Generated by cmake/predecode-assets.cmake\n\n#include \"assets.hpp\"\n#include \"sprite_cache.hpp\"\n\n")
+if(predecoded_textures)
+        string(APPEND predecoded_source
+                "__asm__(\n"
+                "    \".pushsection .data.predecoded_assets, \\\"aw\\\"\\n\"\n"
+                "${predecoded_asm}"
+                "    \".popsection\\n\"\n"
+                ");\n\n"
+                "${predecoded_externs}\n"
+                "static PredecodedAsset const predecodedAssets[] = {\n"
+                "${predecoded_entries}"
+                "};\n\n"
+                "std::span<PredecodedAsset const> GetPredecodedAssets() {\n"
+                "    return predecodedAssets;\n"
+                "}\n"
+        )
+else()
+        string(APPEND predecoded_source "std::span<PredecodedAsset const> GetPredecodedAssets() {\n    return {};\n}\n")
+endif()
+
+# Only rewritten when it changes, so unchanged assets do not rebuild it
+file(CONFIGURE OUTPUT ${PREDECODED_ASSETS_DIR}/predecoded_assets.cpp CONTENT "${predecoded_source}" @ONLY)
+set_source_files_properties(${PREDECODED_ASSETS_DIR}/predecoded_assets.cpp PROPERTIES OBJECT_DEPENDS "${predecoded_textures}")
+target_sources(${COMPILE_ID} PRIVATE ${PREDECODED_ASSETS_DIR}/predecoded_assets.cpp)
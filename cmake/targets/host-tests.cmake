@@ -0,0 +1,62 @@
+include_guard()
+
+# Builds the parts of the mod that do not touch the game into a static library, and the tests in test/ against it.
+# The headers in test/stubs and test/bsml_mock stand in for the Quest dependencies.
+include(${CMAKE_CURRENT_SOURCE_DIR}/cmake/utils.cmake)
+
+set(SHARED_DIR ${CMAKE_CURRENT_SOURCE_DIR}/shared)
+
+# Some tests are benchmarks, so build optimized unless asked otherwise
+if(NOT CMAKE_BUILD_TYPE)
+        set(CMAKE_BUILD_TYPE RelWithDebInfo)
+endif()
+
+find_package(fmt REQUIRED)
+find_package(Threads REQUIRED)
+find_package(ZLIB REQUIRED)
+
+add_compile_definitions(MOD_ID="${CMAKE_PROJECT_NAME}")
+add_compile_definitions(VERSION="0.0.0")
+
+add_library(
+        ${CMAKE_PROJECT_NAME}
+        STATIC
+        ${SOURCE_DIR}/boot_history.cpp
+        ${SOURCE_DIR}/diagnostics.cpp
+        ${SOURCE_DIR}/elf_utils.cpp
+        ${SOURCE_DIR}/integrity.cpp
+        ${SOURCE_DIR}/library_usage.cpp
+        ${SOURCE_DIR}/library_utils.cpp
+        ${SOURCE_DIR}/list_items.cpp
+        ${SOURCE_DIR}/list_view.cpp
+        ${SOURCE_DIR}/log_index.cpp
+        ${SOURCE_DIR}/startup_cost.cpp
+)
+
+target_include_directories(${CMAKE_PROJECT_NAME} PUBLIC ${INCLUDE_DIR})
+target_include_directories(${CMAKE_PROJECT_NAME} PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}/test/stubs)
+target_include_directories(${CMAKE_PROJECT_NAME} PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}/test/bsml_mock)
+target_link_libraries(${CMAKE_PROJECT_NAME} PUBLIC fmt::fmt Threads::Threads)
+
+# The PNG decoder of tools/png2rgba, which runs on the build machine for the Quest build
+add_library(png_decoder STATIC ${CMAKE_CURRENT_SOURCE_DIR}/tools/png2rgba/png_decoder.cpp)
+target_include_directories(png_decoder PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}/tools/png2rgba)
+target_link_libraries(png_decoder PUBLIC ZLIB::ZLIB)
+
+include(${CMAKE_CURRENT_SOURCE_DIR}/cmake/gtest.cmake)
+include(${CMAKE_CURRENT_SOURCE_DIR}/cmake/targets/synthetic-libraries.cmake)
+
+# Runs after the test target is created by gtest.cmake
+cmake_language(DEFER DIRECTORY ${CMAKE_SOURCE_DIR} CALL _setup_synthetic_library_tests())
+cmake_language(DEFER DIRECTORY ${CMAKE_SOURCE_DIR} CALL _setup_png_decoder_tests())
+
+function(_setup_synthetic_library_tests)
+        add_dependencies(${CMAKE_PROJECT_NAME}_test synthetic_libraries)
+        target_compile_definitions(${CMAKE_PROJECT_NAME}_test PRIVATE SYNTHETIC_LIBRARY_DIR="${SYNTHETIC_LIBRARY_DIR}")
+        target_link_libraries(${CMAKE_PROJECT_NAME}_test PRIVATE ${CMAKE_DL_LIBS})
+endfunction()
+
+function(_setup_png_decoder_tests)
+        target_compile_definitions(${CMAKE_PROJECT_NAME}_test PRIVATE ASSETS_DIR="${CMAKE_CURRENT_SOURCE_DIR}/assets")
+        target_link_libraries(${CMAKE_PROJECT_NAME}_test PRIVATE png_decoder)
+endfunction()
@@ -0,0 +1,84 @@
+include_guard()
+
+# Builds real shared libraries with known amounts of loader work, for the startup cost benchmark in
+# test/startup_cost_test.cpp. The sources are generated, so the libraries only differ in what the estimate looks at.
+set(SYNTHETIC_LIBRARY_DIR ${CMAKE_BINARY_DIR}/synthetic_libraries)
+set(SYNTHETIC_PROVIDER_SYMBOLS 6000)
+
+# The provider exports the symbols the other libraries look up
+set(provider_source "")
+math(EXPR last_symbol "${SYNTHETIC_PROVIDER_SYMBOLS} - 1")
+foreach(i RANGE ${last_symbol})
+        string(APPEND provider_source "int synthetic_symbol_${i} = ${i};\n")
+endforeach()
+file(GENERATE OUTPUT ${SYNTHETIC_LIBRARY_DIR}/src/provider.c CONTENT "${provider_source}")
+
+add_library(synthetic_provider SHARED ${SYNTHETIC_LIBRARY_DIR}/src/provider.c)
+set_target_properties(synthetic_provider PROPERTIES LIBRARY_OUTPUT_DIRECTORY ${SYNTHETIC_LIBRARY_DIR})
+
+add_custom_target(synthetic_libraries)
+add_dependencies(synthetic_libraries synthetic_provider)
+
+# Adds a library with the given number of symbol relocations (and undefined symbols), relative relocations,
+# constructors and KiB of read-only data
+function(add_synthetic_library name symbols relatives constructors payload_kib)
+        set(source "#include <string.h>\n\n")
+
+        if(symbols GREATER 0)
+                math(EXPR last "${symbols} - 1")
+                foreach(i RANGE ${last})
+                        string(APPEND source "extern int synthetic_symbol_${i};\n")
+                endforeach()
+                string(APPEND source "__attribute__((used)) int* const symbol_table[] = {\n")
+                foreach(i RANGE ${last})
+                        string(APPEND source "    &synthetic_symbol_${i},\n")
+                endforeach()
+                string(APPEND source "};\n\n")
+        endif()
+
+        if(relatives GREATER 0)
+                math(EXPR last "${relatives} - 1")
+                string(APPEND source "static int relative_targets[64];\n")
+                string(APPEND source "__attribute__((used)) int* const relative_table[] = {\n")
+                foreach(i RANGE ${last})
+                        math(EXPR target "${i} % 64")
+                        string(APPEND source "    &relative_targets[${target}],\n")
+                endforeach()
+                string(APPEND source "};\n\n")
+        endif()
+
+        # Each constructor sets up a page of state, like a mod registering its hooks and config
+        if(constructors GREATER 0)
+                math(EXPR last "${constructors} - 1")
+                foreach(i RANGE ${last})
+                        string(APPEND source "static char constructor_state_${i}[4096];\n")
+                        string(APPEND source "__attribute__((constructor)) static void constructor_${i}(void) {\n")
+                        string(APPEND source "    memset(constructor_state_${i}, ${i} & 0xFF, sizeof(constructor_state_${i}));\n")
+                        string(APPEND source "}\n")
+                endforeach()
+                string(APPEND source "\n")
+        endif()
+
+        math(EXPR payload_bytes "${payload_kib} * 1024")
+        string(APPEND source "__attribute__((used)) const char payload[${payload_bytes}] = {1};\n")
+
+        file(GENERATE OUTPUT ${SYNTHETIC_LIBRARY_DIR}/src/${name}.c CONTENT "${source}")
+        add_library(${name} SHARED ${SYNTHETIC_LIBRARY_DIR}/src/${name}.c)
+        target_link_libraries(${name} PRIVATE synthetic_provider)
+        set_target_properties(${name} PROPERTIES LIBRARY_OUTPUT_DIRECTORY ${SYNTHETIC_LIBRARY_DIR})
+        add_dependencies(synthetic_libraries ${name})
+endfunction()
+
+#                                    symbols  relatives  constructors  KiB
+add_synthetic_library(synthetic_00         0          0             0     16)
+add_synthetic_library(synthetic_01       100        500             0     64)
+add_synthetic_library(synthetic_02         0       4000             2    256)
+add_synthetic_library(synthetic_03       400          0             4     16)
+add_synthetic_library(synthetic_04       800       8000             0   1024)
+add_synthetic_library(synthetic_05         0      20000             8     16)
+add_synthetic_library(synthetic_06      1500       1000             2   2048)
+add_synthetic_library(synthetic_07         0          0            32    512)
+add_synthetic_library(synthetic_08      2500      12000             4     64)
+add_synthetic_library(synthetic_09      3500          0            16   4096)
+add_synthetic_library(synthetic_10      5000      30000             8    256)
+add_synthetic_library(synthetic_11      6000      50000            32   4096)
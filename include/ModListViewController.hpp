@@ -2,9 +2,18 @@
 
 #include "custom-types/shared/macros.hpp"
 #include "HMUI/ViewController.hpp"
+#include "UnityEngine/UI/HorizontalLayoutGroup.hpp"
 
 /// @brief Declare a ViewController to let us create UI in the mods menu
 DECLARE_CLASS_CODEGEN(ModList, ModListViewController, HMUI::ViewController) {
     /// @brief Override DidActivate, which is called whenever you enter the menu
     DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
+
+    /// @brief Replaces the titles and columns with ones built from the current state, so the list is never stale
+    DECLARE_INSTANCE_METHOD(void, RefreshLists);
+
+    /// @brief The layout holding the column titles
+    DECLARE_INSTANCE_FIELD(UnityW<UnityEngine::UI::HorizontalLayoutGroup>, titleHorizontalLayout);
+    /// @brief The layout holding the columns, inside the scroll view
+    DECLARE_INSTANCE_FIELD(UnityW<UnityEngine::UI::HorizontalLayoutGroup>, mainLayout);
 };
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief A fixed-size summary of a single boot, stored in the boot history file.
+struct BootRecord {
+    /// @brief The maximum number of failed library hashes kept per boot.
+    static constexpr size_t MaxFailures = 16;
+
+    /// @brief Increasing boot number, 0 marks an unused slot.
+    uint32_t sequence;
+    /// @brief Milliseconds from the mod's setup to the first main menu activation.
+    uint32_t loadTimeMs;
+    /// @brief Seconds since the unix epoch when the record was written.
+    int64_t timestamp;
+
+    uint16_t loadedLibraries;
+    uint16_t failedLibraries;
+    uint16_t loadedMods;
+    uint16_t failedMods;
+    uint16_t loadedEarlyMods;
+    uint16_t failedEarlyMods;
+
+    /// @brief Number of valid entries in failureHashes.
+    uint16_t failureCount;
+    uint16_t reserved;
+
+    /// @brief HashLibraryName() of each library that failed to load.
+    uint32_t failureHashes[MaxFailures];
+
+    /// @brief Checks whether a library with the given name failed to load during this boot.
+    bool HasFailure(std::string_view name) const;
+    /// @brief Checks whether every failure of this boot fit in failureHashes.
+    bool HasAllFailures() const;
+    /// @brief Checks whether everything loaded during this boot.
+    bool IsGood() const;
+};
+
+static_assert(sizeof(BootRecord) == 96, "BootRecord is part of the on-disk format");
+
+/**
+ * @brief Hashes a library filename for storage in a BootRecord.
+ *
+ * @param name The library filename.
+ * @return uint32_t The 32-bit FNV-1a hash of the name.
+ */
+uint32_t HashLibraryName(std::string_view name);
+
+/**
+ * @brief Finds the last boot where everything loaded.
+ *
+ * @param boots The boots to search, oldest first.
+ * @return BootRecord const* The last good boot, or nullptr if every boot had failures.
+ */
+BootRecord const* FindLastGoodBoot(std::vector<BootRecord> const& boots);
+
+/**
+ * @brief Formats the time a boot was recorded, in local time.
+ *
+ * @param record The boot.
+ * @return std::string The date and time, as YYYY-MM-DD HH:MM.
+ */
+std::string FormatBootTime(BootRecord const& record);
+
+/**
+ * @brief Marks the start of this boot, used to compute BootRecord::loadTimeMs.
+ */
+void MarkBootStart();
+
+/**
+ * @brief Gets the records of previous boots, oldest first.
+ *
+ * The history file is memory mapped and read once, subsequent calls return the cached records. A file that could not be
+ * read is left alone, only a file whose header was read and is not valid is recreated by RecordCurrentBoot().
+ *
+ * @return std::vector<BootRecord> const& The previous boot records.
+ */
+std::vector<BootRecord> const& GetPreviousBoots();
+
+/**
+ * @brief Gets the summary of the current boot, built from the current load info.
+ *
+ * @return BootRecord const& The current boot record.
+ */
+BootRecord const& GetCurrentBoot();
+
+/**
+ * @brief Appends the current boot to the history file.
+ *
+ * Only the first call per boot writes anything, with a single write of one record.
+ */
+void RecordCurrentBoot();
+
+/**
+ * @brief Builds a short, human readable summary of the boot history.
+ *
+ * Includes the trend of loaded mod counts and the last boot where nothing failed to load.
+ *
+ * @return std::string The summary, or an empty string if there are no previous boots.
+ */
+std::string GetBootHistorySummary();
@@ -3,6 +3,7 @@
 
 DECLARE_CONFIG(Config) {
     CONFIG_VALUE(showFailedOnStart, bool, "Show failed mods pop-up at start", true, "Show failed mods pop-up in main menu");
+    CONFIG_VALUE(sortModsByStartupCost, bool, "Sort mods by startup cost", false, "Sort loaded mods by their estimated startup cost, most expensive first");
 };
 
 /**
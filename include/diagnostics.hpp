@@ -0,0 +1,32 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/**
+ * @brief Exports everything the mod list knows about the loaded mods, for bug reports.
+ *
+ * Writes the load info of libs, mods and early mods, the loaded mods, the config and the current boot summary as
+ * <files dir>/mod-list_diagnostics.json and a compact binary form as <files dir>/mod-list_diagnostics.bin.
+ * Whether a library is unused is written as unknown (null in the JSON) until the library usage analysis is done.
+ * The files are written on a background thread through a fixed-size buffer, with a single fsync each.
+ * Must be called from the main thread, calls made while an export is running are ignored.
+ *
+ * @return bool Whether an export was started.
+ */
+bool ExportDiagnostics();
+
+/**
+ * @brief Waits for a running diagnostics export to finish.
+ *
+ * @param timeout The longest time to wait.
+ * @return bool Whether no export is running anymore, false if it timed out.
+ */
+bool WaitForDiagnosticsExport(std::chrono::milliseconds timeout);
+
+/**
+ * @brief Gets the path of the JSON diagnostics file.
+ *
+ * @return std::string const& The path.
+ */
+std::string const& GetDiagnosticsPath();
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+/// @brief A read-only memory mapping of a whole file, unmapped when destroyed.
+struct MappedFile {
+    MappedFile() = default;
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    /**
+     * @brief Maps a file read-only.
+     *
+     * @param path The file to map.
+     * @param sequential Whether the file will be read front to back, enables aggressive readahead.
+     * @return std::optional<MappedFile> The mapping, or nullopt if the file could not be opened or mapped.
+     */
+    static std::optional<MappedFile> Open(std::string const& path, bool sequential = false);
+
+    std::span<uint8_t const> data() const {
+        return {address, size};
+    }
+
+   private:
+    uint8_t const* address = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief Checks that the ELF headers of a file do not point past its end.
+ *
+ * Interrupted copies leave truncated files behind, whose section or segment tables end past EOF.
+ *
+ * @param data The contents of the file.
+ * @return std::optional<std::string> A description of the problem, or nullopt if the file looks complete.
+ */
+std::optional<std::string> CheckElfBounds(std::span<uint8_t const> data);
+
+/// @brief Information about an ELF library, read from its program headers and dynamic section.
+struct ElfLibraryInfo {
+    /// @brief The DT_NEEDED entries, the libraries this library links against.
+    std::vector<std::string> needed;
+    /// @brief The total size of the loadable segments, rounded up to whole pages.
+    uint64_t mappedSize = 0;
+    /// @brief The number of entries in .rela.dyn and .rela.plt.
+    uint64_t relocationCount = 0;
+    /// @brief The number of relative relocations (DT_RELACOUNT), which need no symbol lookup.
+    uint64_t relativeRelocationCount = 0;
+    /// @brief The number of undefined dynamic symbols, each needs a lookup through the loaded libraries.
+    uint64_t undefinedSymbolCount = 0;
+    /// @brief The number of constructors in .init_array, run when the library is loaded.
+    uint64_t initArrayCount = 0;
+};
+
+/**
+ * @brief Reads the dependencies and load cost of an ELF library.
+ *
+ * @param data The contents of the library.
+ * @return std::optional<ElfLibraryInfo> The library info, or nullopt if the file is not a valid 64-bit ELF library.
+ */
+std::optional<ElfLibraryInfo> ReadElfLibraryInfo(std::span<uint8_t const> data);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "elf_utils.hpp"
+
+/// @brief The ELF info of every intact library the integrity scan read, keyed by path relative to the modloader files dir.
+using ScannedLibraries = std::unordered_map<std::string, ElfLibraryInfo>;
+
+/**
+ * @brief Hashes a block of memory with XXH64.
+ *
+ * @param data The data to hash.
+ * @param seed The seed of the hash.
+ * @return uint64_t The 64-bit hash.
+ */
+uint64_t HashContents(std::span<uint8_t const> data, uint64_t seed = 0);
+
+/**
+ * @brief Starts checking every file in libs, mods and early_mods for truncation and corruption.
+ *
+ * The files are memory mapped and hashed on background threads. Hashes of files that loaded successfully are kept as
+ * known-good records, a file whose contents change without its size or modification time changing is reported as corrupted.
+ * Records of files that no longer exist are dropped. The ELF info of every library is read from the same mapping, see
+ * GetScannedLibraries().
+ * Must be called from the main thread once the load info is available, subsequent calls do nothing.
+ */
+void StartIntegrityScan();
+
+/**
+ * @brief Gets the ELF info the integrity scan reads from every library, so other analyses do not map and parse them again.
+ *
+ * The result is ready once every file was mapped, before the known-good records are compared and written.
+ * Must be called from the main thread after StartIntegrityScan(), the returned future may be used from any thread.
+ *
+ * @return std::shared_future<ScannedLibraries> The libraries, invalid if the scan was never started.
+ */
+std::shared_future<ScannedLibraries> GetScannedLibraries();
+
+/**
+ * @brief Waits for the integrity scan to finish.
+ *
+ * @param timeout The longest time to wait.
+ * @return bool Whether the scan is done, false if it timed out or was never started.
+ */
+bool WaitForIntegrityScan(std::chrono::milliseconds timeout);
+
+/**
+ * @brief Gets the integrity problem found for a file.
+ *
+ * Returns nullptr while the scan is still running.
+ *
+ * @param directory The directory the file is in, relative to the modloader files dir (libs, mods or early_mods).
+ * @param filename The filename of the file.
+ * @return std::string const* A description of the problem, or nullptr if none was found.
+ */
+std::string const* GetIntegrityIssue(std::string_view directory, std::string_view filename);
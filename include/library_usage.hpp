@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// @brief What removing a library nobody links against would save.
+struct UnusedLibrary {
+    /// @brief The memory mapped for the library's loadable segments.
+    uint64_t mappedSize;
+    /// @brief The number of relocations the dynamic linker applies when loading the library.
+    uint64_t relocationCount;
+    /// @brief The cost of loading the library, from EstimateStartupCost().
+    double startupCost;
+};
+
+/**
+ * @brief Starts finding the libraries in libs that no mod needs, on a background thread.
+ *
+ * Every file in mods and early_mods is a root, and their DT_NEEDED entries are followed transitively through libs. The
+ * direct dependents of every library are kept as well. The ELF info comes from the integrity scan, which is started if needed.
+ * Must be called from the main thread, subsequent calls do nothing, the loaded libraries cannot change without a restart.
+ */
+void StartLibraryUsageAnalysis();
+
+/**
+ * @brief Checks whether the library usage analysis has finished.
+ *
+ * @return bool Whether the analysis is done, false while it runs or if it was never started.
+ */
+bool IsLibraryUsageAnalysisDone();
+
+/**
+ * @brief Gets the savings of removing a library, if no mod needs it.
+ *
+ * Returns nullptr while the analysis is still running.
+ *
+ * @param filename The filename of the library in libs.
+ * @return UnusedLibrary const* The estimated savings, or nullptr if the library is needed (or the analysis is not done).
+ */
+UnusedLibrary const* GetUnusedLibrary(std::string_view filename);
+
+/**
+ * @brief Gets the mods and libraries that link directly against a library.
+ *
+ * Returns nullptr while the analysis is still running.
+ *
+ * @param filename The filename of the library in libs.
+ * @return std::vector<std::string> const* The filenames of the mods and libraries that need it, or nullptr if there are none.
+ */
+std::vector<std::string> const* GetLibraryDependents(std::string_view filename);
+
+/**
+ * @brief Describes who needs a library, for use in a hover hint.
+ *
+ * @param dependents The mods and libraries that need the library.
+ * @return std::string The description.
+ */
+std::string DescribeLibraryDependents(std::vector<std::string> const& dependents);
+
+/**
+ * @brief Describes the savings of removing an unused library, for use in a hover hint.
+ *
+ * Once the startup cost estimate is done, this includes the library's startup cost on the scale of the loaded mods.
+ *
+ * @param library The unused library.
+ * @return std::string The description.
+ */
+std::string DescribeUnusedLibrary(UnusedLibrary const& library);
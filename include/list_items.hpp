@@ -0,0 +1,63 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "boot_history.hpp"
+#include "library_utils.hpp"
+#include "scotland2/shared/modloader.h"
+
+/// @brief A single line of text in one of the mod list columns.
+struct ListItem {
+    std::string content;
+    std::string hoverHint;
+    /// @brief More hover hint text that is slow to gather, only built when the hover hint is first shown.
+    std::function<std::string()> lazyHoverHint;
+};
+
+/**
+ * @brief Builds the list items for every library in the load info.
+ *
+ * Successfully loaded libraries are shown in green with the mods and libraries that need them as a hover hint, or yellow if
+ * no mod needs them. Failed ones are shown in red with the failure reason as a hover hint.
+ *
+ * @param loadInfo The load info to build the list from.
+ * @param directory The directory the libraries are in, relative to the modloader files dir.
+ * @return std::vector<ListItem> One item per library.
+ */
+std::vector<ListItem> GetLibraryListItems(LibraryLoadInfo const& loadInfo, std::string_view directory);
+
+/**
+ * @brief Builds the list items for every library in the load info that failed to load.
+ *
+ * @param loadInfo The load info to build the list from.
+ * @param directory The directory the libraries are in, relative to the modloader files dir.
+ * @param previousBoots The previous boots, oldest first. Failures that did not happen during the last good boot are marked
+ * as new, with when they started failing.
+ * @return std::vector<ListItem> One item per failed library, with the failure reason as a hover hint.
+ */
+std::vector<ListItem> GetFailedListItems(LibraryLoadInfo const& loadInfo, std::string_view directory, std::vector<BootRecord> const& previousBoots = {});
+
+/**
+ * @brief Builds the list items for every loaded mod whose path starts with the given path.
+ *
+ * @param loadedMods The mods reported by modloader_get_loaded().
+ * @param path The directory the mods must be loaded from.
+ * @param sortByStartupCost Whether to show the estimated startup cost and put the most expensive mods first.
+ * @return std::vector<ListItem> One item per matching mod, showing its id, version and the errors and warnings it logged.
+ * The last error lines are only read from the log when the hover hint is shown.
+ */
+std::vector<ListItem> GetLoadedModListItems(CModResults const& loadedMods, std::string_view path, bool sortByStartupCost = false);
+
+/**
+ * @brief Gets the reason each library in the load info failed to load, for the fail dialog.
+ *
+ * @param loadInfo The load info to read the failures from.
+ * @param directory The directory the libraries are in, relative to the modloader files dir.
+ * @return std::unordered_map<std::string, std::string> The failure reason of each failed library, led by the integrity
+ * problem of the file if one was found.
+ */
+std::unordered_map<std::string, std::string> GetFailureReasons(LibraryLoadInfo const& loadInfo, std::string_view directory);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bsml/shared/BSML-Lite.hpp"
+#include "HMUI/HoverHint.hpp"
+#include "HMUI/ImageView.hpp"
+#include "list_items.hpp"
+#include "UnityEngine/RectTransform.hpp"
+#include "UnityEngine/UI/VerticalLayoutGroup.hpp"
+#include "UnityEngine/Vector2.hpp"
+
+/**
+ * @brief Creates a column of the mod list, with its title in the title row.
+ *
+ * @param parent The layout to add the column to.
+ * @param titleParent The layout to add the title to.
+ * @param columnWidth The width of the column.
+ * @param title The title of the column.
+ * @param content One line of text per item, with its hover hint. Lazy hover hints are registered with SetLazyHoverHint().
+ * @param titleHoverHint The hover hint of the title, none if empty.
+ */
+void CreateListWithTitle(
+    BSML::Lite::TransformWrapper parent,
+    BSML::Lite::TransformWrapper titleParent,
+    float columnWidth,
+    std::string title,
+    std::vector<ListItem> const& content,
+    std::string const& titleHoverHint = ""
+);
+
+/**
+ * @brief Creates the five columns of the mod list from the modloader's load results, the log and the analyses.
+ *
+ * @param parent The layout to add the columns to.
+ * @param titleParent The layout to add their titles to.
+ * @param sortByStartupCost Whether to put the most expensive mods first, with their startup cost.
+ */
+void CreateModLists(BSML::Lite::TransformWrapper parent, BSML::Lite::TransformWrapper titleParent, bool sortByStartupCost);
+
+/**
+ * @brief Makes a hover hint append more text the first time it is shown.
+ *
+ * @param hoverHint The hover hint, already showing its base text.
+ * @param baseText The text the hover hint was created with.
+ * @param details Builds the text to append, or nullopt if it is not known yet and should be asked for again the next time
+ * the hover hint is shown. Called until it returns a value.
+ */
+void SetLazyHoverHint(HMUI::HoverHint* hoverHint, std::string baseText, std::function<std::optional<std::string>()> details);
+
+/// @brief Builds the text of a lazy hover hint, if it has one and it was not built yet. Called right before it is shown.
+void ResolveLazyHoverHint(HMUI::HoverHint* hoverHint);
+
+/// @brief Forgets every lazy hover hint, call it before destroying the objects they are on.
+void ClearLazyHoverHints();
+
+/**
+ * @brief Draws a list of failed mods in the GUI.
+ *
+ * @param layout The layout to draw the list in.
+ * @param failedMods The list of failed mods.
+ * @param title The title of the list.
+ * @param directory The directory the mods are in, relative to the modloader files dir. If the integrity scan is still
+ * running, its finding for each mod is added to the hover hint once it is done.
+ */
+void drawFailedList(
+    UnityEngine::UI::VerticalLayoutGroup* layout,
+    std::unordered_map<std::string, std::string> const& failedMods,
+    std::string const& title,
+    std::string_view directory = {}
+);
+
+/// @brief Creates a canvas with specified size and position, and attaches it to the given parent.
+/// @param parent The parent transform to attach the canvas to.
+/// @param sizeDelta The size of the canvas.
+/// @param anchoredPosition The anchored position of the canvas.
+/// @return A pointer to the created RectTransform.
+UnityEngine::RectTransform* createCanvas(BSML::Lite::TransformWrapper parent, UnityEngine::Vector2 sizeDelta, UnityEngine::Vector2 anchoredPosition);
+
+/// @brief Draws a line between two points, as a stretched and rotated white pixel.
+/// @param parent The parent transform to draw the line in.
+/// @param start The start of the line.
+/// @param end The end of the line.
+/// @param thickness The thickness of the line.
+/// @return A pointer to the image of the line.
+HMUI::ImageView* drawLine(BSML::Lite::TransformWrapper parent, UnityEngine::Vector2 const start, UnityEngine::Vector2 const end, float thickness = 0.3f);
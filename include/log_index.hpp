@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// @brief The number of warnings and errors a mod logged during this session.
+struct ModLogSummary {
+    uint32_t warnings;
+    uint32_t errors;
+};
+
+/**
+ * @brief Indexes the new lines of this session's log file.
+ *
+ * Only the bytes written since the last call are mapped and scanned. For every logging tag the warning and error
+ * counts are kept, along with the offsets of the last few error lines.
+ */
+void UpdateLogIndex();
+
+/**
+ * @brief Gets the number of warnings and errors logged by a mod, from the index only.
+ *
+ * Matches the logging tags that are the mod id, or the mod id followed by "_" and a version (e.g. "mod-list_1.0.0").
+ *
+ * @param modId The id of the mod.
+ * @return std::optional<ModLogSummary> The summary, or nullopt if the mod logged no warnings or errors.
+ */
+std::optional<ModLogSummary> GetModLogSummary(std::string_view modId);
+
+/**
+ * @brief Reads the last few error lines logged by a mod back from the log.
+ *
+ * Matches the same tags as GetModLogSummary(). Unlike it, this reads the log file, so it is meant to be called on demand.
+ *
+ * @param modId The id of the mod.
+ * @return std::string The error lines, newest last and separated by newlines, or empty if there are none.
+ */
+std::string GetRecentModErrors(std::string_view modId);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "assets.hpp"
+#include "UnityEngine/Sprite.hpp"
+
+/// @brief The header tools/png2rgba writes in front of the pixels of a pre-decoded texture.
+struct RawTextureHeader {
+    char magic[4];
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+};
+
+/// @brief A PNG asset and the pre-decoded texture cmake/predecode-assets.cmake embedded for it.
+struct PredecodedAsset {
+    IncludedAsset const& png;
+    RawTextureHeader const& header;
+    IncludedAsset pixels;  ///< The pixels alone, as an il2cpp array
+};
+
+/// @brief All the pre-decoded textures, generated at configure time.
+std::span<PredecodedAsset const> GetPredecodedAssets();
+
+/**
+ * @brief Gets the sprite for an embedded image, creating it on first use.
+ *
+ * PNGs with a pre-decoded texture (see GetPredecodedAssets) are uploaded straight from it, anything else is decoded.
+ * The sprite is cached, so repeated uses of the same asset are free.
+ *
+ * @param asset The embedded PNG.
+ * @return UnityEngine::Sprite* The sprite, or nullptr if the asset could not be loaded.
+ */
+UnityEngine::Sprite* GetCachedSprite(IncludedAsset const& asset);
+
+#define CACHED_SPRITE(asset) GetCachedSprite(asset)
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+#include "elf_utils.hpp"
+
+/**
+ * @brief Starts estimating the startup cost of every loaded mod, on a background thread.
+ *
+ * The estimate uses the ELF info read by the integrity scan, which is started if needed. Must be called from the main
+ * thread, subsequent calls do nothing.
+ */
+void StartStartupCostEstimate();
+
+/**
+ * @brief Estimates the cost of loading a library, from its relocation counts, undefined symbols, .init_array size and
+ * mapped size.
+ *
+ * @param info The ELF info of the library.
+ * @return double The cost, in arbitrary units that only make sense compared to other libraries.
+ */
+double EstimateStartupCost(ElfLibraryInfo const& info);
+
+/**
+ * @brief Gets the estimated startup cost of a loaded mod.
+ *
+ * The cost is relative, the most expensive loaded mod scores 100.
+ *
+ * @param path The path of the mod, as reported by modloader_get_loaded().
+ * @return std::optional<int> The cost, or nullopt if the mod is unknown or the estimate is not done.
+ */
+std::optional<int> GetStartupCost(std::string_view path);
+
+/**
+ * @brief Puts a cost from EstimateStartupCost() on the same scale as GetStartupCost(), where the most expensive loaded mod
+ * scores 100.
+ *
+ * @param cost The cost of a library.
+ * @return std::optional<int> The scaled cost, may be over 100, or nullopt if the estimate is not done yet.
+ */
+std::optional<int> ScaleStartupCost(double cost);
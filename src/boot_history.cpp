@@ -0,0 +1,274 @@
+#include "boot_history.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <optional>
+#include <string>
+
+#include "fmt/format.h"
+#include "library_utils.hpp"
+#include "logger.hpp"
+#include "scotland2/shared/modloader.h"
+
+/// @brief The header at the start of the boot history file, written once when the file is created.
+struct BootHistoryHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t capacity;
+    uint32_t reserved;
+};
+
+/// @brief What was found when reading the boot history file.
+enum class BootHistoryState {
+    /// @brief There is no history yet, the file does not exist or is empty.
+    Missing,
+    Valid,
+    /// @brief The header was read and is not one this version writes.
+    Invalid,
+    /// @brief The file exists but could not be read, it must not be overwritten.
+    Unreadable,
+};
+
+static constexpr uint32_t bootHistoryMagic = 0x544F4F42;  // "BOOT"
+static constexpr uint16_t bootHistoryVersion = 1;
+static constexpr uint32_t bootHistoryCapacity = 64;
+
+static std::chrono::steady_clock::time_point bootStart = std::chrono::steady_clock::now();
+static BootHistoryState bootHistoryState = BootHistoryState::Missing;
+
+static std::string const& GetBootHistoryPath() {
+    static std::string path = fmt::format("{}/{}_boot_history.bin", modloader_get_files_dir(), MOD_ID);
+    return path;
+}
+
+static bool IsValidHeader(BootHistoryHeader const& header) {
+    return header.magic == bootHistoryMagic && header.version == bootHistoryVersion && header.recordSize == sizeof(BootRecord) &&
+           header.capacity == bootHistoryCapacity;
+}
+
+uint32_t HashLibraryName(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool BootRecord::HasFailure(std::string_view name) const {
+    uint32_t hash = HashLibraryName(name);
+    uint32_t const* end = failureHashes + std::min<size_t>(failureCount, MaxFailures);
+    return std::find(failureHashes, end, hash) != end;
+}
+
+bool BootRecord::HasAllFailures() const {
+    return failureCount == failedLibraries + failedMods + failedEarlyMods;
+}
+
+bool BootRecord::IsGood() const {
+    return failedLibraries == 0 && failedMods == 0 && failedEarlyMods == 0;
+}
+
+BootRecord const* FindLastGoodBoot(std::vector<BootRecord> const& boots) {
+    auto lastGood = std::find_if(boots.rbegin(), boots.rend(), [](BootRecord const& record) {
+        return record.IsGood();
+    });
+    return lastGood == boots.rend() ? nullptr : &*lastGood;
+}
+
+std::string FormatBootTime(BootRecord const& record) {
+    char date[32];
+    std::time_t time = record.timestamp;
+    std::tm tm;
+    localtime_r(&time, &tm);
+    std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M", &tm);
+    return date;
+}
+
+void MarkBootStart() {
+    bootStart = std::chrono::steady_clock::now();
+}
+
+std::vector<BootRecord> const& GetPreviousBoots() {
+    static std::optional<std::vector<BootRecord>> previousBoots;
+    if (previousBoots.has_value()) {
+        return *previousBoots;
+    }
+
+    previousBoots.emplace();
+
+    int fd = open(GetBootHistoryPath().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            Logger.info("No boot history found");
+        } else {
+            Logger.warn("Failed to open boot history: {}", std::strerror(errno));
+            bootHistoryState = BootHistoryState::Unreadable;
+        }
+        return *previousBoots;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        Logger.warn("Failed to read boot history: {}", std::strerror(errno));
+        bootHistoryState = BootHistoryState::Unreadable;
+        close(fd);
+        return *previousBoots;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return *previousBoots;
+    }
+    if (static_cast<size_t>(st.st_size) < sizeof(BootHistoryHeader)) {
+        Logger.warn("Boot history is truncated, it will be recreated");
+        bootHistoryState = BootHistoryState::Invalid;
+        close(fd);
+        return *previousBoots;
+    }
+
+    size_t expectedSize = sizeof(BootHistoryHeader) + bootHistoryCapacity * sizeof(BootRecord);
+    size_t size = std::min(static_cast<size_t>(st.st_size), expectedSize);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        Logger.warn("Failed to map boot history: {}", std::strerror(errno));
+        bootHistoryState = BootHistoryState::Unreadable;
+        return *previousBoots;
+    }
+
+    auto header = static_cast<BootHistoryHeader const*>(mapping);
+    if (IsValidHeader(*header)) {
+        bootHistoryState = BootHistoryState::Valid;
+        auto records = reinterpret_cast<BootRecord const*>(header + 1);
+        size_t recordCount = (size - sizeof(BootHistoryHeader)) / sizeof(BootRecord);
+        for (size_t i = 0; i < recordCount; i++) {
+            if (records[i].sequence != 0) {
+                previousBoots->push_back(records[i]);
+            }
+        }
+        std::sort(previousBoots->begin(), previousBoots->end(), [](BootRecord const& a, BootRecord const& b) {
+            return a.sequence < b.sequence;
+        });
+    } else {
+        Logger.warn("Boot history has an unknown format, it will be recreated");
+        bootHistoryState = BootHistoryState::Invalid;
+    }
+
+    munmap(mapping, size);
+    return *previousBoots;
+}
+
+/// @brief Counts the loaded and failed libraries in the load info, and adds the failures to the record.
+static void CountLoadInfo(LibraryLoadInfo const& loadInfo, uint16_t& loaded, uint16_t& failed, BootRecord& record) {
+    for (auto const& [name, failure] : loadInfo) {
+        if (!failure.has_value()) {
+            loaded++;
+            continue;
+        }
+
+        failed++;
+        if (record.failureCount < BootRecord::MaxFailures) {
+            record.failureHashes[record.failureCount++] = HashLibraryName(name);
+        }
+    }
+}
+
+BootRecord const& GetCurrentBoot() {
+    static std::optional<BootRecord> currentBoot;
+    if (currentBoot.has_value()) {
+        return *currentBoot;
+    }
+
+    BootRecord record{};
+    auto const& previousBoots = GetPreviousBoots();
+    record.sequence = previousBoots.empty() ? 1 : previousBoots.back().sequence + 1;
+    record.loadTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootStart).count();
+    record.timestamp = std::time(nullptr);
+
+    CountLoadInfo(GetModsLoadInfo(), record.loadedMods, record.failedMods, record);
+    CountLoadInfo(GetEarlyModsLoadInfo(), record.loadedEarlyMods, record.failedEarlyMods, record);
+    CountLoadInfo(GetModloaderLibsLoadInfo(), record.loadedLibraries, record.failedLibraries, record);
+
+    currentBoot = record;
+    return *currentBoot;
+}
+
+void RecordCurrentBoot() {
+    static bool recorded = false;
+    if (recorded) {
+        return;
+    }
+    recorded = true;
+
+    BootRecord const& record = GetCurrentBoot();
+    if (bootHistoryState == BootHistoryState::Unreadable) {
+        Logger.warn("Not recording boot {}, the boot history could not be read", record.sequence);
+        return;
+    }
+
+    int fd = open(GetBootHistoryPath().c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        Logger.warn("Failed to open boot history for writing: {}", std::strerror(errno));
+        return;
+    }
+
+    off_t slot = sizeof(BootHistoryHeader) + ((record.sequence - 1) % bootHistoryCapacity) * sizeof(BootRecord);
+    ssize_t written;
+    if (bootHistoryState == BootHistoryState::Valid) {
+        written = pwrite(fd, &record, sizeof(record), slot);
+    } else {
+        // Start a fresh file, the header and the first record go out in a single write
+        struct {
+            BootHistoryHeader header;
+            BootRecord record;
+        } initial{{bootHistoryMagic, bootHistoryVersion, sizeof(BootRecord), bootHistoryCapacity, 0}, record};
+        written = ftruncate(fd, 0) == 0 ? pwrite(fd, &initial, sizeof(initial), 0) : -1;
+    }
+    int error = errno;
+    close(fd);
+
+    if (written < 0) {
+        Logger.warn("Failed to write boot history: {}", std::strerror(error));
+    } else {
+        Logger.info("Recorded boot {} ({} ms)", record.sequence, record.loadTimeMs);
+    }
+}
+
+std::string GetBootHistorySummary() {
+    auto const& previousBoots = GetPreviousBoots();
+    if (previousBoots.empty()) {
+        return {};
+    }
+
+    BootRecord const& current = GetCurrentBoot();
+
+    // Show the loaded mod count of the last few boots, ending with this one
+    constexpr size_t trendLength = 8;
+    size_t first = previousBoots.size() > trendLength - 1 ? previousBoots.size() - (trendLength - 1) : 0;
+    std::string summary = "Loaded mods per boot: ";
+    for (size_t i = first; i < previousBoots.size(); i++) {
+        summary += fmt::format("{}, ", previousBoots[i].loadedMods + previousBoots[i].loadedEarlyMods);
+    }
+    summary += fmt::format("{} (now)", current.loadedMods + current.loadedEarlyMods);
+
+    BootRecord const& previous = previousBoots.back();
+    summary += fmt::format("\nLoad time: {} ms (last boot {} ms)", current.loadTimeMs, previous.loadTimeMs);
+
+    // Find the last boot where everything loaded
+    if (auto lastGood = FindLastGoodBoot(previousBoots)) {
+        summary += fmt::format("\nLast boot without failures: {} ({} boots ago)", FormatBootTime(*lastGood), current.sequence - lastGood->sequence);
+    } else {
+        summary += fmt::format("\nNo boot without failures in the last {} boots", previousBoots.size());
+    }
+
+    return summary;
+}
@@ -1,7 +1,9 @@
 #include "config.hpp"
 
+#include "bsml/shared/BSML-Lite/Creation/Buttons.hpp"
 #include "bsml/shared/BSML-Lite/Creation/Layout.hpp"
 #include "config-utils/shared/config-utils.hpp"
+#include "diagnostics.hpp"
 #include "HMUI/ViewController.hpp"
 #include "UnityEngine/GameObject.hpp"
 
@@ -12,5 +14,11 @@ void ConfigViewDidActivate(HMUI::ViewController* self, bool firstActivation, boo
         auto container = BSML::Lite::CreateScrollableSettingsContainer(self->get_transform());
 
         AddConfigValueToggle(container, getConfig().showFailedOnStart);
+        AddConfigValueToggle(container, getConfig().sortModsByStartupCost);
+
+        // Write everything we know about the loaded mods to a file, for bug reports
+        BSML::Lite::CreateUIButton(container, "Export diagnostics", []() {
+            ExportDiagnostics();
+        });
     }
 }
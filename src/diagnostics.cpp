@@ -0,0 +1,386 @@
+#include "diagnostics.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "boot_history.hpp"
+#include "config.hpp"
+#include "fmt/format.h"
+#include "integrity.hpp"
+#include "library_usage.hpp"
+#include "library_utils.hpp"
+#include "logger.hpp"
+#include "scotland2/shared/modloader.h"
+#include "startup_cost.hpp"
+
+/// @brief A mod reported by modloader_get_loaded().
+struct LoadedModSnapshot {
+    std::string id;
+    std::string version;
+    std::string path;
+};
+
+/// @brief Everything exported, gathered on the main thread.
+struct DiagnosticsSnapshot {
+    // The load info never changes once it has been read, so it is safe to share with the export thread
+    LibraryLoadInfo const* libraries;
+    LibraryLoadInfo const* mods;
+    LibraryLoadInfo const* earlyMods;
+    std::vector<LoadedModSnapshot> loadedMods;
+    BootRecord boot;
+    bool showFailedOnStart;
+    bool sortModsByStartupCost;
+    /// @brief Whether the library usage analysis was done when the snapshot was taken, so both files agree.
+    bool libraryUsageDone;
+    int64_t timestamp;
+};
+
+/// @brief Streams data to a file through a fixed-size buffer.
+///
+/// The data goes to a temporary file that replaces the destination in Finish(), after a single fsync.
+class StreamWriter {
+   public:
+    explicit StreamWriter(std::string path) : path(std::move(path)) {
+        fd = open((this->path + ".tmp").c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        failed = fd < 0;
+    }
+
+    StreamWriter(StreamWriter const&) = delete;
+    StreamWriter& operator=(StreamWriter const&) = delete;
+
+    ~StreamWriter() {
+        if (fd >= 0) {
+            close(fd);
+            std::remove((path + ".tmp").c_str());
+        }
+    }
+
+    void Write(std::string_view data) {
+        while (!data.empty()) {
+            if (used == buffer.size()) {
+                Flush();
+            }
+            size_t count = std::min(data.size(), buffer.size() - used);
+            std::memcpy(buffer.data() + used, data.data(), count);
+            used += count;
+            data.remove_prefix(count);
+        }
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void WriteValue(T value) {
+        Write({reinterpret_cast<char const*>(&value), sizeof(value)});
+    }
+
+    template <typename... Args>
+    void WriteFormat(fmt::format_string<Args...> format, Args&&... args) {
+        // Format into the remaining buffer space when it fits, so nothing is allocated
+        auto result = fmt::format_to_n(buffer.data() + used, buffer.size() - used, format, std::forward<Args>(args)...);
+        if (result.size <= buffer.size() - used) {
+            used += result.size;
+        } else {
+            Write(fmt::format(format, std::forward<Args>(args)...));
+        }
+    }
+
+    /// @brief Flushes the buffer, syncs the file to storage and moves it into place.
+    bool Finish() {
+        Flush();
+        if (!failed) {
+            failed = fsync(fd) != 0;
+        }
+        failed = close(fd) != 0 || failed;
+        fd = -1;
+
+        std::string tempPath = path + ".tmp";
+        if (failed || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+   private:
+    void Flush() {
+        size_t written = 0;
+        while (!failed && written < used) {
+            ssize_t result = write(fd, buffer.data() + written, used - written);
+            if (result < 0) {
+                failed = true;
+            } else {
+                written += result;
+            }
+        }
+        used = 0;
+    }
+
+    std::string path;
+    int fd;
+    bool failed;
+    size_t used = 0;
+    std::array<char, 64 * 1024> buffer;
+};
+
+static std::atomic<bool> exportRunning = false;
+static std::mutex exportMutex;
+static std::condition_variable exportFinished;
+
+std::string const& GetDiagnosticsPath() {
+    static std::string path = fmt::format("{}/{}_diagnostics.json", modloader_get_files_dir(), MOD_ID);
+    return path;
+}
+
+static std::string const& GetBinaryDiagnosticsPath() {
+    static std::string path = fmt::format("{}/{}_diagnostics.bin", modloader_get_files_dir(), MOD_ID);
+    return path;
+}
+
+/// @brief Writes a string as a quoted JSON string.
+static void WriteJsonString(StreamWriter& writer, std::string_view value) {
+    writer.Write("\"");
+    size_t start = 0;
+    for (size_t i = 0; i < value.size(); i++) {
+        unsigned char c = value[i];
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+
+        writer.Write(value.substr(start, i - start));
+        switch (c) {
+            case '"':
+                writer.Write("\\\"");
+                break;
+            case '\\':
+                writer.Write("\\\\");
+                break;
+            case '\n':
+                writer.Write("\\n");
+                break;
+            case '\t':
+                writer.Write("\\t");
+                break;
+            default:
+                writer.WriteFormat("\\u{:04x}", c);
+                break;
+        }
+        start = i + 1;
+    }
+    writer.Write(value.substr(start));
+    writer.Write("\"");
+}
+
+static void WriteJsonOptionalString(StreamWriter& writer, std::string const* value) {
+    if (value) {
+        WriteJsonString(writer, *value);
+    } else {
+        writer.Write("null");
+    }
+}
+
+static void WriteJsonLoadInfo(StreamWriter& writer, std::string_view directory, LibraryLoadInfo const& loadInfo, bool libraryUsageDone) {
+    writer.Write("[");
+    bool first = true;
+    for (auto const& [name, failure] : loadInfo) {
+        writer.Write(first ? "\n    {\"name\": " : ",\n    {\"name\": ");
+        first = false;
+        WriteJsonString(writer, name);
+        writer.Write(", \"failure\": ");
+        WriteJsonOptionalString(writer, failure.has_value() ? &*failure : nullptr);
+        writer.Write(", \"integrityIssue\": ");
+        WriteJsonOptionalString(writer, GetIntegrityIssue(directory, name));
+        if (directory == "libs" && !libraryUsageDone) {
+            writer.Write(", \"unused\": null}");
+        } else if (directory == "libs") {
+            writer.Write(GetUnusedLibrary(name) ? ", \"unused\": true}" : ", \"unused\": false}");
+        } else {
+            writer.Write("}");
+        }
+    }
+    writer.Write(first ? "]" : "\n  ]");
+}
+
+static bool WriteJson(DiagnosticsSnapshot const& snapshot) {
+    StreamWriter writer(GetDiagnosticsPath());
+
+    writer.Write("{\n  \"generator\": ");
+    WriteJsonString(writer, MOD_ID " " VERSION);
+    writer.WriteFormat(",\n  \"timestamp\": {},\n", snapshot.timestamp);
+    writer.WriteFormat(
+        "  \"config\": {{\"showFailedOnStart\": {}, \"sortModsByStartupCost\": {}}},\n",
+        snapshot.showFailedOnStart,
+        snapshot.sortModsByStartupCost
+    );
+
+    BootRecord const& boot = snapshot.boot;
+    writer.WriteFormat(
+        "  \"boot\": {{\"sequence\": {}, \"loadTimeMs\": {}, \"loadedLibraries\": {}, \"failedLibraries\": {}, \"loadedMods\": {}, "
+        "\"failedMods\": {}, \"loadedEarlyMods\": {}, \"failedEarlyMods\": {}}},\n",
+        boot.sequence,
+        boot.loadTimeMs,
+        boot.loadedLibraries,
+        boot.failedLibraries,
+        boot.loadedMods,
+        boot.failedMods,
+        boot.loadedEarlyMods,
+        boot.failedEarlyMods
+    );
+
+    writer.Write("  \"loaded\": [");
+    for (size_t i = 0; i < snapshot.loadedMods.size(); i++) {
+        LoadedModSnapshot const& mod = snapshot.loadedMods[i];
+        writer.Write(i == 0 ? "\n    {\"id\": " : ",\n    {\"id\": ");
+        WriteJsonString(writer, mod.id);
+        writer.Write(", \"version\": ");
+        WriteJsonString(writer, mod.version);
+        writer.Write(", \"path\": ");
+        WriteJsonString(writer, mod.path);
+        if (auto cost = GetStartupCost(mod.path)) {
+            writer.WriteFormat(", \"startupCost\": {}}}", *cost);
+        } else {
+            writer.Write(", \"startupCost\": null}");
+        }
+    }
+    writer.Write(snapshot.loadedMods.empty() ? "],\n" : "\n  ],\n");
+
+    writer.Write("  \"libraries\": ");
+    WriteJsonLoadInfo(writer, "libs", *snapshot.libraries, snapshot.libraryUsageDone);
+    writer.Write(",\n  \"mods\": ");
+    WriteJsonLoadInfo(writer, "mods", *snapshot.mods, snapshot.libraryUsageDone);
+    writer.Write(",\n  \"earlyMods\": ");
+    WriteJsonLoadInfo(writer, "early_mods", *snapshot.earlyMods, snapshot.libraryUsageDone);
+    writer.Write("\n}\n");
+
+    return writer.Finish();
+}
+
+// Version 2 added the unknown state of the unused flag
+static constexpr uint32_t binaryVersion = 2;
+static constexpr uint8_t unusedUnknown = 0xFF;
+
+/// @brief Writes a string as its 32-bit length followed by its bytes, a length of 0xFFFFFFFF marks a missing string.
+static void WriteBinaryString(StreamWriter& writer, std::string const* value) {
+    if (!value) {
+        writer.WriteValue<uint32_t>(UINT32_MAX);
+        return;
+    }
+    writer.WriteValue<uint32_t>(value->size());
+    writer.Write(*value);
+}
+
+static void WriteBinaryLoadInfo(StreamWriter& writer, uint8_t section, std::string_view directory, LibraryLoadInfo const& loadInfo, bool libraryUsageDone) {
+    writer.WriteValue<uint8_t>(section);
+    writer.WriteValue<uint32_t>(loadInfo.size());
+    for (auto const& [name, failure] : loadInfo) {
+        WriteBinaryString(writer, &name);
+        WriteBinaryString(writer, failure.has_value() ? &*failure : nullptr);
+        WriteBinaryString(writer, GetIntegrityIssue(directory, name));
+        if (directory == "libs" && !libraryUsageDone) {
+            writer.WriteValue<uint8_t>(unusedUnknown);
+        } else {
+            writer.WriteValue<uint8_t>(directory == "libs" && GetUnusedLibrary(name));
+        }
+    }
+}
+
+/**
+ * Layout, all values little endian:
+ *   "MLDG", uint32 version, int64 timestamp, uint8 config flags, BootRecord
+ *   uint8 section 4, uint32 count, count * (string id, string version, string path, int32 startup cost or -1)
+ *   uint8 section 1 (libs), 2 (mods), 3 (early mods), uint32 count,
+ *       count * (string name, string failure, string integrity issue, uint8 unused: 0 no, 1 yes, 0xFF unknown)
+ */
+static bool WriteBinary(DiagnosticsSnapshot const& snapshot) {
+    StreamWriter writer(GetBinaryDiagnosticsPath());
+
+    writer.Write("MLDG");
+    writer.WriteValue<uint32_t>(binaryVersion);
+    writer.WriteValue<int64_t>(snapshot.timestamp);
+    writer.WriteValue<uint8_t>(snapshot.showFailedOnStart | snapshot.sortModsByStartupCost << 1);
+    writer.WriteValue(snapshot.boot);
+
+    writer.WriteValue<uint8_t>(4);
+    writer.WriteValue<uint32_t>(snapshot.loadedMods.size());
+    for (auto const& mod : snapshot.loadedMods) {
+        WriteBinaryString(writer, &mod.id);
+        WriteBinaryString(writer, &mod.version);
+        WriteBinaryString(writer, &mod.path);
+        writer.WriteValue<int32_t>(GetStartupCost(mod.path).value_or(-1));
+    }
+
+    WriteBinaryLoadInfo(writer, 1, "libs", *snapshot.libraries, snapshot.libraryUsageDone);
+    WriteBinaryLoadInfo(writer, 2, "mods", *snapshot.mods, snapshot.libraryUsageDone);
+    WriteBinaryLoadInfo(writer, 3, "early_mods", *snapshot.earlyMods, snapshot.libraryUsageDone);
+
+    return writer.Finish();
+}
+
+bool ExportDiagnostics() {
+    if (exportRunning.exchange(true)) {
+        Logger.info("Diagnostics export already running");
+        return false;
+    }
+
+    // Gather the snapshot here, the load info and config must be read on the main thread
+    DiagnosticsSnapshot snapshot;
+    snapshot.libraries = &GetModloaderLibsLoadInfo();
+    snapshot.mods = &GetModsLoadInfo();
+    snapshot.earlyMods = &GetEarlyModsLoadInfo();
+    snapshot.boot = GetCurrentBoot();
+    snapshot.showFailedOnStart = getConfig().showFailedOnStart.GetValue();
+    snapshot.sortModsByStartupCost = getConfig().sortModsByStartupCost.GetValue();
+    snapshot.libraryUsageDone = IsLibraryUsageAnalysisDone();
+    snapshot.timestamp = std::time(nullptr);
+
+    auto loadedMods = modloader_get_loaded();
+    snapshot.loadedMods.reserve(loadedMods.size);
+    for (size_t i = 0; i < loadedMods.size; i++) {
+        CModResult const& mod = loadedMods.array[i];
+        snapshot.loadedMods.push_back({mod.info.id, mod.info.version, mod.path});
+    }
+
+    // Make sure the paths exist before leaving the main thread
+    GetDiagnosticsPath();
+    GetBinaryDiagnosticsPath();
+
+    std::thread([snapshot = std::move(snapshot)]() {
+        auto start = std::chrono::steady_clock::now();
+
+        bool jsonWritten = WriteJson(snapshot);
+        bool binaryWritten = WriteBinary(snapshot);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        if (jsonWritten && binaryWritten) {
+            Logger.info("Exported diagnostics to {} in {} ms", GetDiagnosticsPath(), elapsed);
+        } else {
+            Logger.error("Failed to export diagnostics (json: {}, binary: {})", jsonWritten, binaryWritten);
+        }
+
+        std::lock_guard lock(exportMutex);
+        exportRunning = false;
+        exportFinished.notify_all();
+    }).detach();
+
+    return true;
+}
+
+bool WaitForDiagnosticsExport(std::chrono::milliseconds timeout) {
+    std::unique_lock lock(exportMutex);
+    return exportFinished.wait_for(lock, timeout, []() {
+        return !exportRunning;
+    });
+}
@@ -0,0 +1,267 @@
+#include "elf_utils.hpp"
+
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "fmt/format.h"
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : address(std::exchange(other.address, nullptr)), size(std::exchange(other.size, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (address) {
+            munmap(const_cast<uint8_t*>(address), size);
+        }
+        address = std::exchange(other.address, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if (address) {
+        munmap(const_cast<uint8_t*>(address), size);
+    }
+}
+
+std::optional<MappedFile> MappedFile::Open(std::string const& path, bool sequential) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return std::nullopt;
+    }
+
+    MappedFile file;
+    if (st.st_size == 0) {
+        // Empty files cannot be mapped, but are still valid (empty) files
+        close(fd);
+        return file;
+    }
+
+    void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+
+    if (sequential) {
+        madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+    }
+
+    file.address = static_cast<uint8_t const*>(mapping);
+    file.size = st.st_size;
+    return file;
+}
+
+/// @brief Checks that count entries of entrySize bytes starting at offset lie within size bytes, without overflowing.
+static bool RangeFits(uint64_t offset, uint64_t count, uint64_t entrySize, uint64_t size) {
+    if (offset > size) {
+        return false;
+    }
+    return entrySize == 0 || count <= (size - offset) / entrySize;
+}
+
+std::optional<std::string> CheckElfBounds(std::span<uint8_t const> data) {
+    if (data.size() < EI_NIDENT || std::memcmp(data.data(), ELFMAG, SELFMAG) != 0) {
+        return fmt::format("File is not a valid ELF library ({} bytes), it may be truncated or corrupted", data.size());
+    }
+    if (data[EI_CLASS] != ELFCLASS64) {
+        return std::nullopt;
+    }
+    if (data.size() < sizeof(Elf64_Ehdr)) {
+        return fmt::format("File is truncated: the ELF header needs {} bytes but the file is {} bytes", sizeof(Elf64_Ehdr), data.size());
+    }
+
+    Elf64_Ehdr header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    if (!RangeFits(header.e_phoff, header.e_phnum, header.e_phentsize, data.size())) {
+        return fmt::format(
+            "File is truncated: {} program headers start at {} but the file is {} bytes", header.e_phnum, header.e_phoff, data.size()
+        );
+    }
+
+    if (header.e_phentsize == sizeof(Elf64_Phdr)) {
+        for (size_t i = 0; i < header.e_phnum; i++) {
+            Elf64_Phdr segment;
+            std::memcpy(&segment, data.data() + header.e_phoff + i * sizeof(Elf64_Phdr), sizeof(segment));
+            if (segment.p_type == PT_LOAD && !RangeFits(segment.p_offset, segment.p_filesz, 1, data.size())) {
+                return fmt::format(
+                    "File is truncated: a loadable segment of {} bytes starts at {} but the file is {} bytes",
+                    segment.p_filesz,
+                    segment.p_offset,
+                    data.size()
+                );
+            }
+        }
+    }
+
+    if (!RangeFits(header.e_shoff, header.e_shnum, header.e_shentsize, data.size())) {
+        return fmt::format(
+            "File is truncated: {} section headers start at {} but the file is {} bytes", header.e_shnum, header.e_shoff, data.size()
+        );
+    }
+
+    if (header.e_shentsize == sizeof(Elf64_Shdr)) {
+        for (size_t i = 0; i < header.e_shnum; i++) {
+            Elf64_Shdr section;
+            std::memcpy(&section, data.data() + header.e_shoff + i * sizeof(Elf64_Shdr), sizeof(section));
+            if (section.sh_type != SHT_NOBITS && !RangeFits(section.sh_offset, section.sh_size, 1, data.size())) {
+                return fmt::format(
+                    "File is truncated: section {} of {} bytes starts at {} but the file is {} bytes",
+                    i,
+                    section.sh_size,
+                    section.sh_offset,
+                    data.size()
+                );
+            }
+        }
+    }
+
+    return std::nullopt;
+}
+
+/// @brief Converts a virtual address to a file offset using the loadable segments.
+static std::optional<uint64_t> VirtualAddressToOffset(std::span<Elf64_Phdr const> segments, uint64_t address) {
+    for (auto const& segment : segments) {
+        if (segment.p_type == PT_LOAD && address >= segment.p_vaddr && address - segment.p_vaddr < segment.p_filesz) {
+            return address - segment.p_vaddr + segment.p_offset;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<ElfLibraryInfo> ReadElfLibraryInfo(std::span<uint8_t const> data) {
+    if (CheckElfBounds(data).has_value() || data[EI_CLASS] != ELFCLASS64) {
+        return std::nullopt;
+    }
+
+    Elf64_Ehdr header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.e_phentsize != sizeof(Elf64_Phdr) || header.e_phoff % alignof(Elf64_Phdr) != 0) {
+        return std::nullopt;
+    }
+
+    // Bounds were checked above, and the mapping is page aligned, so the headers can be used in place
+    std::span<Elf64_Phdr const> segments(reinterpret_cast<Elf64_Phdr const*>(data.data() + header.e_phoff), header.e_phnum);
+
+    ElfLibraryInfo info;
+    Elf64_Phdr const* dynamicSegment = nullptr;
+    for (auto const& segment : segments) {
+        if (segment.p_type == PT_LOAD) {
+            uint64_t pageSize = std::max<uint64_t>(segment.p_align, 4096);
+            uint64_t start = segment.p_vaddr & ~(pageSize - 1);
+            uint64_t end = (segment.p_vaddr + segment.p_memsz + pageSize - 1) & ~(pageSize - 1);
+            if (end > start) {
+                info.mappedSize += end - start;
+            }
+        } else if (segment.p_type == PT_DYNAMIC) {
+            dynamicSegment = &segment;
+        }
+    }
+
+    if (!dynamicSegment || dynamicSegment->p_offset % alignof(Elf64_Dyn) != 0 ||
+        !RangeFits(dynamicSegment->p_offset, dynamicSegment->p_filesz, 1, data.size())) {
+        return info;
+    }
+
+    std::span<Elf64_Dyn const> dynamic(
+        reinterpret_cast<Elf64_Dyn const*>(data.data() + dynamicSegment->p_offset), dynamicSegment->p_filesz / sizeof(Elf64_Dyn)
+    );
+
+    uint64_t stringTableAddress = 0;
+    uint64_t stringTableSize = 0;
+    uint64_t relaSize = 0;
+    uint64_t relaEntrySize = sizeof(Elf64_Rela);
+    uint64_t pltRelSize = 0;
+    uint64_t pltRelType = DT_RELA;
+    for (auto const& entry : dynamic) {
+        if (entry.d_tag == DT_NULL) {
+            break;
+        }
+        switch (entry.d_tag) {
+            case DT_STRTAB:
+                stringTableAddress = entry.d_un.d_ptr;
+                break;
+            case DT_STRSZ:
+                stringTableSize = entry.d_un.d_val;
+                break;
+            case DT_RELASZ:
+                relaSize = entry.d_un.d_val;
+                break;
+            case DT_RELAENT:
+                relaEntrySize = entry.d_un.d_val;
+                break;
+            case DT_PLTRELSZ:
+                pltRelSize = entry.d_un.d_val;
+                break;
+            case DT_PLTREL:
+                pltRelType = entry.d_un.d_val;
+                break;
+            case DT_RELACOUNT:
+                info.relativeRelocationCount = entry.d_un.d_val;
+                break;
+            case DT_INIT_ARRAYSZ:
+                info.initArrayCount = entry.d_un.d_val / sizeof(Elf64_Addr);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (relaEntrySize != 0) {
+        info.relocationCount += relaSize / relaEntrySize;
+    }
+    info.relocationCount += pltRelSize / (pltRelType == DT_REL ? sizeof(Elf64_Rel) : sizeof(Elf64_Rela));
+
+    // Count the undefined symbols in .dynsym, read in place from the mapping
+    if (header.e_shentsize == sizeof(Elf64_Shdr) && header.e_shoff % alignof(Elf64_Shdr) == 0) {
+        std::span<Elf64_Shdr const> sections(reinterpret_cast<Elf64_Shdr const*>(data.data() + header.e_shoff), header.e_shnum);
+        for (auto const& section : sections) {
+            if (section.sh_type != SHT_DYNSYM || section.sh_entsize != sizeof(Elf64_Sym) || section.sh_offset % alignof(Elf64_Sym) != 0) {
+                continue;
+            }
+            if (!RangeFits(section.sh_offset, section.sh_size / sizeof(Elf64_Sym), sizeof(Elf64_Sym), data.size())) {
+                continue;
+            }
+
+            std::span<Elf64_Sym const> symbols(reinterpret_cast<Elf64_Sym const*>(data.data() + section.sh_offset), section.sh_size / sizeof(Elf64_Sym));
+            for (auto const& symbol : symbols) {
+                if (symbol.st_shndx == SHN_UNDEF && symbol.st_name != 0) {
+                    info.undefinedSymbolCount++;
+                }
+            }
+        }
+    }
+
+    auto stringTableOffset = VirtualAddressToOffset(segments, stringTableAddress);
+    if (!stringTableOffset.has_value() || !RangeFits(*stringTableOffset, stringTableSize, 1, data.size())) {
+        return info;
+    }
+
+    std::string_view stringTable(reinterpret_cast<char const*>(data.data() + *stringTableOffset), stringTableSize);
+    for (auto const& entry : dynamic) {
+        if (entry.d_tag == DT_NULL) {
+            break;
+        }
+        if (entry.d_tag == DT_NEEDED && entry.d_un.d_val < stringTable.size()) {
+            std::string_view name = stringTable.substr(entry.d_un.d_val);
+            info.needed.emplace_back(name.substr(0, name.find('\0')));
+        }
+    }
+
+    return info;
+}
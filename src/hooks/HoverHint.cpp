@@ -0,0 +1,14 @@
+#include "autohooks/shared/hooks.hpp"
+#include "list_view.hpp"
+
+// HMUI
+#include "HMUI/HoverHint.hpp"
+
+// UnityEngine::EventSystems
+#include "UnityEngine/EventSystems/PointerEventData.hpp"
+
+// Builds the slow part of lazy hover hints right before they are shown
+MAKE_LATE_HOOK_MATCH(HoverHint_OnPointerEnter, &HMUI::HoverHint::OnPointerEnter, void, HMUI::HoverHint* self, UnityEngine::EventSystems::PointerEventData* eventData) {
+    ResolveLazyHoverHint(self);
+    HoverHint_OnPointerEnter(self, eventData);
+}
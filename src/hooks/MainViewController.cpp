@@ -1,6 +1,9 @@
 #include "autohooks/shared/hooks.hpp"
+#include "boot_history.hpp"
 #include "config.hpp"
 #include "library_utils.hpp"
+#include "list_items.hpp"
+#include "list_view.hpp"
 #include "logger.hpp"
 
 // BSML
@@ -26,44 +29,6 @@ using namespace UnityEngine::UI;
 #include "TMPro/TextMeshProUGUI.hpp"
 using namespace TMPro;
 
-/**
- * @brief Draws a list of failed mods in the GUI.
- *
- * @param layout The layout to draw the list in.
- * @param failedMods The list of failed mods.
- * @param title The title of the list.
- */
-void drawFailedList(VerticalLayoutGroup* layout, std::unordered_map<std::string, std::string> const& failedMods, std::string const& title) {
-    if (failedMods.size() > 0) {
-        // Create the title text for the failed mods
-        TextMeshProUGUI* modsTitleText = Lite::CreateText(layout, title);
-        modsTitleText->set_fontSize(5.0f);
-        modsTitleText->set_alignment(TextAlignmentOptions::Top);
-        modsTitleText->get_transform().cast<RectTransform>()->set_sizeDelta({70, 4});
-
-        auto separator = Lite::CreateText(layout, "_____________________________________________________________________________________________");
-        separator->set_alignment(TextAlignmentOptions::Bottom);
-        separator->get_transform().cast<RectTransform>()->set_sizeDelta({70, 4});
-        separator->set_overflowMode(TextOverflowModes::Overflow);
-        ;
-
-        // Add the failed mods to the GUI
-        for (std::pair<std::string, std::string> failedMod : failedMods) {
-            TextMeshProUGUI* modText = Lite::CreateText(layout, fmt::format("<color=red>{}</color>", failedMod.first.c_str()));
-            modText->set_overflowMode(TextOverflowModes::Overflow);
-            modText->set_fontSize(3.5f);
-            modText->set_alignment(TextAlignmentOptions::Top);
-            modText->get_transform().cast<RectTransform>()->get_transform().cast<RectTransform>()->set_sizeDelta({70, 3.5});
-
-            Lite::AddHoverHint(
-                modText, failedMod.second
-            );  // Show the full fail reason in a hover hint, since there most likely won't be enough space in the modal view
-        }
-
-        Lite::CreateText(layout, " ")->get_transform().cast<RectTransform>()->set_sizeDelta({70, 1});
-    }
-}
-
 // Displays a modal view if mods fail to load showing why
 MAKE_LATE_HOOK_MATCH(
     MainMenuViewController_DidActivate,
@@ -82,6 +47,9 @@ MAKE_LATE_HOOK_MATCH(
         return;
     }
 
+    // Add this boot to the boot history
+    RecordCurrentBoot();
+
     // Check if we should show the failed mods on game start
     if (getConfig().showFailedOnStart.GetValue() == false) {
         Logger.info("Showing failed mods on game start is disabled! Returning");
@@ -90,24 +58,13 @@ MAKE_LATE_HOOK_MATCH(
 
     // Check for failed mods
     Logger.info("Checking for failed mods . . .");
-    auto modsLoadInfo = GetModsLoadInfo();
-    auto earlyModsLoadInfo = GetEarlyModsLoadInfo();
-
-    // Check if there are any failed mods
-    auto failedMods = std::unordered_map<std::string, std::string>();
-    for (auto modPair : modsLoadInfo) {
-        if (modPair.second.has_value()) {
-            failedMods[modPair.first] = *modPair.second;
-        }
-    }
+    auto& modsLoadInfo = GetModsLoadInfo();
+    auto& earlyModsLoadInfo = GetEarlyModsLoadInfo();
 
-    // Check if there are any failed early mods
-    auto failedEarlyMods = std::unordered_map<std::string, std::string>();
-    for (auto modPair : earlyModsLoadInfo) {
-        if (modPair.second.has_value()) {
-            failedEarlyMods[modPair.first] = *modPair.second;
-        }
-    }
+    // Check if there are any failed mods and early mods. The integrity scan is not waited for, rows get its findings when
+    // they are hovered after it is done.
+    auto failedMods = GetFailureReasons(modsLoadInfo, "mods");
+    auto failedEarlyMods = GetFailureReasons(earlyModsLoadInfo, "early_mods");
 
     // Log the failed mods
     Logger.info("%lu mods failed to load", failedMods.size());
@@ -135,6 +92,7 @@ MAKE_LATE_HOOK_MATCH(
     // Destroy the modal view when it's hidden
     modalView->onHide = [modalView]() {
         Logger.info("Fail dialog closed, destroying modal view!");
+        ClearLazyHoverHints();
         UnityEngine::GameObject::Destroy(modalView->get_gameObject());
     };
 
@@ -170,10 +128,10 @@ MAKE_LATE_HOOK_MATCH(
     }
 
     // Add the failed mods to the GUI
-    drawFailedList(layout, failedMods, failedModsText);
+    drawFailedList(layout, failedMods, failedModsText, "mods");
 
     // Add the failed early mods to the GUI
-    drawFailedList(layout, failedEarlyMods, failedEarlyModsText);
+    drawFailedList(layout, failedEarlyMods, failedEarlyModsText, "early_mods");
 
     Lite::CreateUIButton(layout, "Close", [modalView]() {
         modalView->Hide();
@@ -0,0 +1,396 @@
+#include "integrity.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <optional>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "fmt/format.h"
+#include "library_utils.hpp"
+#include "logger.hpp"
+#include "scotland2/shared/modloader.h"
+
+/// @brief A file found in one of the scanned directories.
+struct ScannedFile {
+    std::string relativePath;
+    uint64_t size;
+    int64_t mtime;
+    bool loaded;
+};
+
+/// @brief The hash of a file from the last boot it loaded successfully.
+struct KnownGoodRecord {
+    uint64_t size;
+    int64_t mtime;
+    uint64_t hash;
+};
+
+/// @brief The result of checking a single file.
+struct ScanResult {
+    std::optional<uint64_t> hash;
+    std::optional<std::string> issue;
+    std::optional<ElfLibraryInfo> libraryInfo;
+};
+
+using IntegrityIssues = std::unordered_map<std::string, std::string>;
+
+static std::shared_future<IntegrityIssues> integrityScan;
+static std::shared_future<ScannedLibraries> scannedLibraries;
+
+static constexpr uint64_t prime1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4Full;
+static constexpr uint64_t prime3 = 0x165667B19E3779F9ull;
+static constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ull;
+static constexpr uint64_t prime5 = 0x27D4EB2F165667C5ull;
+
+static inline uint64_t Read64(uint8_t const* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t Read32(uint8_t const* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t HashRound(uint64_t acc, uint64_t input) {
+    acc += input * prime2;
+    acc = std::rotl(acc, 31);
+    return acc * prime1;
+}
+
+static inline uint64_t HashMergeRound(uint64_t acc, uint64_t value) {
+    acc ^= HashRound(0, value);
+    return acc * prime1 + prime4;
+}
+
+uint64_t HashContents(std::span<uint8_t const> data, uint64_t seed) {
+    uint8_t const* p = data.data();
+    uint8_t const* end = p + data.size();
+    uint64_t hash;
+
+    if (data.size() >= 32) {
+        // Four independent lanes keep the multipliers busy, 32 bytes per iteration
+        uint64_t v1 = seed + prime1 + prime2;
+        uint64_t v2 = seed + prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - prime1;
+        uint8_t const* limit = end - 32;
+        do {
+            v1 = HashRound(v1, Read64(p));
+            v2 = HashRound(v2, Read64(p + 8));
+            v3 = HashRound(v3, Read64(p + 16));
+            v4 = HashRound(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+        hash = HashMergeRound(hash, v1);
+        hash = HashMergeRound(hash, v2);
+        hash = HashMergeRound(hash, v3);
+        hash = HashMergeRound(hash, v4);
+    } else {
+        hash = seed + prime5;
+    }
+
+    hash += data.size();
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= HashRound(0, Read64(p));
+        hash = std::rotl(hash, 27) * prime1 + prime4;
+    }
+    if (p + 4 <= end) {
+        hash ^= uint64_t(Read32(p)) * prime1;
+        hash = std::rotl(hash, 23) * prime2 + prime3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= *p * prime5;
+        hash = std::rotl(hash, 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+static std::string const& GetKnownGoodPath() {
+    static std::string path = fmt::format("{}/{}_known_good.txt", modloader_get_files_dir(), MOD_ID);
+    return path;
+}
+
+/// @brief Reads the known-good records, stored as one "path\tsize\tmtime\thash" line per file.
+static std::unordered_map<std::string, KnownGoodRecord> ReadKnownGoodRecords() {
+    std::unordered_map<std::string, KnownGoodRecord> records;
+
+    auto file = MappedFile::Open(GetKnownGoodPath());
+    if (!file.has_value()) {
+        return records;
+    }
+
+    std::string_view contents(reinterpret_cast<char const*>(file->data().data()), file->data().size());
+    while (!contents.empty()) {
+        size_t lineEnd = contents.find('\n');
+        std::string_view line = contents.substr(0, lineEnd);
+        contents = lineEnd == std::string_view::npos ? std::string_view() : contents.substr(lineEnd + 1);
+
+        size_t first = line.find('\t');
+        size_t second = line.find('\t', first + 1);
+        size_t third = line.find('\t', second + 1);
+        if (first == std::string_view::npos || second == std::string_view::npos || third == std::string_view::npos) {
+            continue;
+        }
+
+        KnownGoodRecord record;
+        char const* lineEndPtr = line.data() + line.size();
+        if (std::from_chars(line.data() + first + 1, line.data() + second, record.size).ec != std::errc() ||
+            std::from_chars(line.data() + second + 1, line.data() + third, record.mtime).ec != std::errc() ||
+            std::from_chars(line.data() + third + 1, lineEndPtr, record.hash, 16).ec != std::errc()) {
+            continue;
+        }
+        records.emplace(line.substr(0, first), record);
+    }
+
+    return records;
+}
+
+static void WriteKnownGoodRecords(std::unordered_map<std::string, KnownGoodRecord> const& records) {
+    std::string contents;
+    for (auto const& [path, record] : records) {
+        fmt::format_to(std::back_inserter(contents), "{}\t{}\t{}\t{:x}\n", path, record.size, record.mtime, record.hash);
+    }
+
+    // Write to a temporary file first, so an interrupted write never loses the previous records
+    std::string tempPath = GetKnownGoodPath() + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        Logger.warn("Failed to write known-good records");
+        return;
+    }
+    bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok || std::rename(tempPath.c_str(), GetKnownGoodPath().c_str()) != 0) {
+        Logger.warn("Failed to write known-good records");
+        std::remove(tempPath.c_str());
+    }
+}
+
+/// @brief Lists the regular files in a directory of the modloader files dir.
+static void ListFiles(std::string const& filesDir, std::string_view directory, LibraryLoadInfo const& loadInfo, std::vector<ScannedFile>& files) {
+    std::string path = fmt::format("{}/{}", filesDir, directory);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return;
+    }
+
+    while (dirent* entry = readdir(dir)) {
+        struct stat st;
+        if (fstatat(dirfd(dir), entry->d_name, &st, 0) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+
+        auto loadResult = loadInfo.find(entry->d_name);
+        bool loaded = loadResult != loadInfo.end() && !loadResult->second.has_value();
+        files.push_back({fmt::format("{}/{}", directory, entry->d_name), static_cast<uint64_t>(st.st_size), st.st_mtime, loaded});
+    }
+
+    closedir(dir);
+}
+
+static ScanResult ScanFile(std::string const& filesDir, ScannedFile const& file) {
+    ScanResult result;
+
+    auto mapping = MappedFile::Open(fmt::format("{}/{}", filesDir, file.relativePath), true);
+    if (!mapping.has_value()) {
+        result.issue = "File could not be read";
+        return result;
+    }
+
+    if (file.relativePath.ends_with(".so")) {
+        result.issue = CheckElfBounds(mapping->data());
+        if (!result.issue.has_value()) {
+            result.libraryInfo = ReadElfLibraryInfo(mapping->data());
+        }
+    }
+    result.hash = HashContents(mapping->data());
+    return result;
+}
+
+static IntegrityIssues ScanFiles(std::string const& filesDir, std::vector<ScannedFile>& files, std::promise<ScannedLibraries>& libraries) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Hash the largest files first so the workers finish at roughly the same time
+    std::sort(files.begin(), files.end(), [](ScannedFile const& a, ScannedFile const& b) {
+        return a.size > b.size;
+    });
+
+    std::vector<ScanResult> results(files.size());
+    std::atomic<size_t> nextFile = 0;
+    auto worker = [&]() {
+        for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+            // An exception escaping a worker thread would terminate the game, skip the file instead
+            try {
+                results[i] = ScanFile(filesDir, files[i]);
+            } catch (std::exception const& e) {
+                Logger.error("Failed to check {}: {}", files[i].relativePath, e.what());
+            }
+        }
+    };
+
+    size_t workerCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 4);
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < workerCount; i++) {
+        // Out of threads is not a reason to skip the scan, this thread and the workers already started do the rest
+        try {
+            workers.emplace_back(worker);
+        } catch (std::system_error const& e) {
+            Logger.warn("Failed to start integrity scan worker: {}", e.what());
+            break;
+        }
+    }
+    worker();
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    // Hand the library info to the other analyses before the slower known-good bookkeeping
+    ScannedLibraries libraryInfo;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (results[i].libraryInfo.has_value()) {
+            libraryInfo.emplace(files[i].relativePath, std::move(*results[i].libraryInfo));
+        }
+    }
+    libraries.set_value(std::move(libraryInfo));
+
+    // Compare against, and update, the known-good records
+    auto knownGood = ReadKnownGoodRecords();
+    IntegrityIssues issues;
+    uint64_t totalBytes = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        ScannedFile const& file = files[i];
+        ScanResult& result = results[i];
+        totalBytes += file.size;
+
+        if (!result.issue.has_value() && result.hash.has_value()) {
+            auto record = knownGood.find(file.relativePath);
+            if (record != knownGood.end() && record->second.size == file.size && record->second.mtime == file.mtime &&
+                record->second.hash != *result.hash) {
+                result.issue = "File contents changed since it last loaded successfully, but its size and modification time did not. The file may be corrupted";
+            }
+        }
+
+        if (result.issue.has_value()) {
+            Logger.warn("Integrity problem with {}: {}", file.relativePath, *result.issue);
+            issues.emplace(file.relativePath, std::move(*result.issue));
+        } else if (file.loaded && result.hash.has_value()) {
+            knownGood[file.relativePath] = {file.size, file.mtime, *result.hash};
+        }
+    }
+
+    // Drop the records of files that were deleted, so the file does not grow forever
+    std::unordered_set<std::string_view> scannedPaths;
+    for (auto const& file : files) {
+        scannedPaths.insert(file.relativePath);
+    }
+    std::erase_if(knownGood, [&](auto const& record) {
+        return !scannedPaths.contains(record.first);
+    });
+    WriteKnownGoodRecords(knownGood);
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Logger.info(
+        "Checked {} files ({:.1f} MB) in {:.0f} ms with {} threads, {:.2f} GB/s",
+        files.size(),
+        totalBytes / 1e6,
+        elapsed * 1e3,
+        workers.size() + 1,
+        elapsed > 0 ? totalBytes / elapsed / 1e9 : 0.0
+    );
+
+    return issues;
+}
+
+static IntegrityIssues RunIntegrityScan(std::string filesDir, std::vector<ScannedFile> files, std::promise<ScannedLibraries> libraries) {
+    // The results are read on the UI thread, so a failed scan has to finish with nothing found rather than an exception
+    try {
+        return ScanFiles(filesDir, files, libraries);
+    } catch (std::exception const& e) {
+        Logger.error("Integrity scan failed: {}", e.what());
+    }
+    try {
+        libraries.set_value({});
+    } catch (std::future_error const&) {
+        // The library info was already handed over before the failure
+    }
+    return {};
+}
+
+void StartIntegrityScan() {
+    if (integrityScan.valid()) {
+        return;
+    }
+
+    // Gather everything from the load info here, it is not safe to touch from the worker threads
+    std::string filesDir = modloader_get_files_dir();
+    std::vector<ScannedFile> files;
+    ListFiles(filesDir, "libs", GetModloaderLibsLoadInfo(), files);
+    ListFiles(filesDir, "mods", GetModsLoadInfo(), files);
+    ListFiles(filesDir, "early_mods", GetEarlyModsLoadInfo(), files);
+
+    Logger.info("Starting integrity scan of {} files", files.size());
+    std::promise<ScannedLibraries> libraries;
+    scannedLibraries = libraries.get_future().share();
+    try {
+        integrityScan = std::async(std::launch::async, RunIntegrityScan, std::move(filesDir), std::move(files), std::move(libraries)).share();
+    } catch (std::system_error const& e) {
+        // The promise went with the failed task, so hand out empty results in its place
+        Logger.error("Failed to start integrity scan: {}", e.what());
+        std::promise<IntegrityIssues> noIssues;
+        noIssues.set_value({});
+        integrityScan = noIssues.get_future().share();
+        std::promise<ScannedLibraries> noLibraries;
+        noLibraries.set_value({});
+        scannedLibraries = noLibraries.get_future().share();
+    }
+}
+
+std::shared_future<ScannedLibraries> GetScannedLibraries() {
+    return scannedLibraries;
+}
+
+bool WaitForIntegrityScan(std::chrono::milliseconds timeout) {
+    return integrityScan.valid() && integrityScan.wait_for(timeout) == std::future_status::ready;
+}
+
+std::string const* GetIntegrityIssue(std::string_view directory, std::string_view filename) {
+    if (!integrityScan.valid() || integrityScan.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return nullptr;
+    }
+
+    auto const& issues = integrityScan.get();
+    if (issues.empty()) {
+        return nullptr;
+    }
+
+    auto issue = issues.find(fmt::format("{}/{}", directory, filename));
+    return issue == issues.end() ? nullptr : &issue->second;
+}
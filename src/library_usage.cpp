@@ -0,0 +1,156 @@
+#include "library_usage.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iterator>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include "fmt/format.h"
+#include "fmt/ranges.h"
+#include "integrity.hpp"
+#include "logger.hpp"
+#include "startup_cost.hpp"
+
+/// @brief The result of the analysis.
+struct LibraryUsage {
+    std::unordered_map<std::string, UnusedLibrary> unused;
+    std::unordered_map<std::string, std::vector<std::string>> dependents;
+};
+
+static std::shared_future<LibraryUsage> libraryUsageAnalysis;
+
+static LibraryUsage RunLibraryUsageAnalysis(std::shared_future<ScannedLibraries> scannedLibraries) {
+    auto const& scanned = scannedLibraries.get();
+    auto start = std::chrono::steady_clock::now();
+
+    // Split the libraries read by the integrity scan by directory, keyed by filename
+    std::unordered_map<std::string, ElfLibraryInfo const*> libraries;
+    std::unordered_map<std::string, ElfLibraryInfo const*> mods;
+    std::unordered_map<std::string, ElfLibraryInfo const*> earlyMods;
+    for (auto const& [path, info] : scanned) {
+        std::string_view relativePath = path;
+        size_t slash = relativePath.find('/');
+        std::string_view directory = relativePath.substr(0, slash);
+        std::string filename(relativePath.substr(slash + 1));
+        if (directory == "libs") {
+            libraries.emplace(std::move(filename), &info);
+        } else if (directory == "mods") {
+            mods.emplace(std::move(filename), &info);
+        } else if (directory == "early_mods") {
+            earlyMods.emplace(std::move(filename), &info);
+        }
+    }
+
+    // Record who links against each library, mods first
+    LibraryUsage usage;
+    for (auto const* dependents : {&mods, &earlyMods, &libraries}) {
+        for (auto const& [name, info] : *dependents) {
+            for (auto const& library : info->needed) {
+                if (libraries.contains(library)) {
+                    usage.dependents[library].push_back(name);
+                }
+            }
+        }
+    }
+    for (auto& [library, dependents] : usage.dependents) {
+        std::sort(dependents.begin(), dependents.end());
+    }
+
+    // Walk the dependency graph from every mod, marking the libraries it reaches
+    std::unordered_map<std::string_view, bool> needed;
+    std::vector<std::string_view> pending;
+    for (auto const* roots : {&mods, &earlyMods}) {
+        for (auto const& [name, info] : *roots) {
+            pending.insert(pending.end(), info->needed.begin(), info->needed.end());
+        }
+    }
+    while (!pending.empty()) {
+        std::string_view name = pending.back();
+        pending.pop_back();
+
+        auto library = libraries.find(std::string(name));
+        if (library == libraries.end() || needed[library->first]) {
+            continue;
+        }
+
+        needed[library->first] = true;
+        pending.insert(pending.end(), library->second->needed.begin(), library->second->needed.end());
+    }
+
+    for (auto const& [name, info] : libraries) {
+        if (needed[name]) {
+            continue;
+        }
+
+        usage.unused.emplace(name, UnusedLibrary{info->mappedSize, info->relocationCount, EstimateStartupCost(*info)});
+        Logger.info("Library {} is not needed by any mod", name);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    Logger.info("Found {} unused of {} libraries in {} ms", usage.unused.size(), libraries.size(), elapsed);
+
+    return usage;
+}
+
+void StartLibraryUsageAnalysis() {
+    if (libraryUsageAnalysis.valid()) {
+        return;
+    }
+
+    // The integrity scan already maps every library, use what it read instead of mapping them again
+    StartIntegrityScan();
+    try {
+        libraryUsageAnalysis = std::async(std::launch::async, RunLibraryUsageAnalysis, GetScannedLibraries()).share();
+    } catch (std::system_error const& e) {
+        // Finish with nothing found, the getters run on the UI thread and must not throw
+        Logger.error("Failed to start library usage analysis: {}", e.what());
+        std::promise<LibraryUsage> noUsage;
+        noUsage.set_value({});
+        libraryUsageAnalysis = noUsage.get_future().share();
+    }
+}
+
+bool IsLibraryUsageAnalysisDone() {
+    return libraryUsageAnalysis.valid() && libraryUsageAnalysis.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+UnusedLibrary const* GetUnusedLibrary(std::string_view filename) {
+    if (!IsLibraryUsageAnalysisDone()) {
+        return nullptr;
+    }
+
+    auto const& unused = libraryUsageAnalysis.get().unused;
+    auto library = unused.find(std::string(filename));
+    return library == unused.end() ? nullptr : &library->second;
+}
+
+std::vector<std::string> const* GetLibraryDependents(std::string_view filename) {
+    if (!IsLibraryUsageAnalysisDone()) {
+        return nullptr;
+    }
+
+    auto const& dependents = libraryUsageAnalysis.get().dependents;
+    auto library = dependents.find(std::string(filename));
+    return library == dependents.end() ? nullptr : &library->second;
+}
+
+std::string DescribeLibraryDependents(std::vector<std::string> const& dependents) {
+    return fmt::format("Needed by {}", fmt::join(dependents, ", "));
+}
+
+std::string DescribeUnusedLibrary(UnusedLibrary const& library) {
+    std::string description = fmt::format(
+        "No installed mod links against this library. Removing it would save about {} KiB of memory and {} relocations",
+        library.mappedSize / 1024,
+        library.relocationCount
+    );
+
+    // The cost is only meaningful next to the mods', so it is shown on the scale of the loaded mods column
+    if (auto cost = ScaleStartupCost(library.startupCost)) {
+        fmt::format_to(std::back_inserter(description), ", with a startup cost of {} (the most expensive mod is 100)", *cost);
+    }
+    return description;
+}
@@ -4,6 +4,8 @@
 #include <dlfcn.h>
 #include <sys/types.h>
 
+#include <filesystem>
+
 #include "fmt/format.h"
 #include "logger.hpp"
 #include "scotland2/shared/modloader.h"
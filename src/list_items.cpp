@@ -0,0 +1,176 @@
+#include "list_items.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+#include "fmt/format.h"
+#include "integrity.hpp"
+#include "library_usage.hpp"
+#include "log_index.hpp"
+#include "logger.hpp"
+#include "startup_cost.hpp"
+
+/// @brief Puts the integrity problem of a file, if one was found, at the top of the hover hint.
+static void AddIntegrityIssue(ListItem& item, std::string_view directory, std::string const& name) {
+    if (auto issue = GetIntegrityIssue(directory, name)) {
+        item.hoverHint = item.hoverHint.empty() ? *issue : fmt::format("{}\n{}", *issue, item.hoverHint);
+    }
+}
+
+std::vector<ListItem> GetLibraryListItems(LibraryLoadInfo const& loadInfo, std::string_view directory) {
+    std::vector<ListItem> result;
+    result.reserve(loadInfo.size());
+
+    for (auto const& [name, failure] : loadInfo) {
+        if (failure.has_value()) {
+            // If there was an error loading the library, display it in red
+            Logger.debug("Adding failed library {}", name);
+            result.push_back({"<color=red>" + name, *failure});  // Allow you to hover over the mod to see the fail reason
+        } else if (auto unused = GetUnusedLibrary(name)) {
+            // Libraries that no mod needs are shown in yellow, with what removing them would save
+            Logger.debug("Adding unused library {}", name);
+            result.push_back({"<color=yellow>" + name, DescribeUnusedLibrary(*unused)});
+        } else {
+            // Otherwise, make the library name green, with what needs it
+            Logger.debug("Adding successful library {}", name);
+            auto dependents = GetLibraryDependents(name);
+            result.push_back({"<color=green>" + name, dependents ? DescribeLibraryDependents(*dependents) : std::string()});
+        }
+        AddIntegrityIssue(result.back(), directory, name);
+    }
+
+    return result;
+}
+
+/// @brief Describes how a failure changed since the last good boot, or nullopt if the history cannot tell.
+static std::optional<std::string> DescribeFailureHistory(std::string const& name, std::vector<BootRecord> const& previousBoots, bool& isNew) {
+    // Compare with the last boot where everything loaded, or the oldest boot kept if there is none
+    BootRecord const* baseline = FindLastGoodBoot(previousBoots);
+    if (!baseline && !previousBoots.empty() && previousBoots.front().HasAllFailures()) {
+        baseline = &previousBoots.front();
+    }
+    if (!baseline) {
+        return std::nullopt;
+    }
+
+    // Find when the library started failing, walking back through the boots since the baseline
+    BootRecord const* failingSince = nullptr;
+    for (auto boot = previousBoots.rbegin(); &*boot != baseline; boot++) {
+        if (!boot->HasAllFailures()) {
+            return std::nullopt;
+        }
+        if (!boot->HasFailure(name)) {
+            break;
+        }
+        failingSince = &*boot;
+    }
+
+    isNew = !baseline->HasFailure(name);
+    std::string since = failingSince ? fmt::format("Failing since {}", FormatBootTime(*failingSince)) : "Failing since this boot";
+    if (!isNew) {
+        return fmt::format("Already failing {}", baseline->IsGood() ? "in the last good boot" : "in the oldest boot kept");
+    }
+    if (baseline->IsGood()) {
+        return fmt::format("{}, loaded in the last good boot ({})", since, FormatBootTime(*baseline));
+    }
+    return since;
+}
+
+std::vector<ListItem> GetFailedListItems(LibraryLoadInfo const& loadInfo, std::string_view directory, std::vector<BootRecord> const& previousBoots) {
+    std::vector<ListItem> result;
+
+    for (auto const& [name, failure] : loadInfo) {
+        // If there was an error loading the library, add it to the list in red
+        if (failure.has_value()) {
+            Logger.debug("Adding failed mod {}", name);
+            ListItem item{"<color=red>" + name, *failure};  // Allow you to hover over the mod to see the fail reason
+
+            // Point out mods that started failing since the last good boot
+            bool isNew = false;
+            if (auto history = DescribeFailureHistory(name, previousBoots, isNew)) {
+                if (isNew) {
+                    item.content += " <color=yellow>(new)";
+                }
+                item.hoverHint = *history + "\n" + item.hoverHint;
+            }
+            AddIntegrityIssue(item, directory, name);
+            result.push_back(std::move(item));
+        }
+    }
+
+    return result;
+}
+
+std::unordered_map<std::string, std::string> GetFailureReasons(LibraryLoadInfo const& loadInfo, std::string_view directory) {
+    std::unordered_map<std::string, std::string> result;
+    for (auto const& [name, failure] : loadInfo) {
+        if (failure.has_value()) {
+            // Lead with the integrity problem if the file is damaged, it explains the load failure
+            auto issue = GetIntegrityIssue(directory, name);
+            result[name] = issue ? fmt::format("{}\n{}", *issue, *failure) : *failure;
+        }
+    }
+    return result;
+}
+
+std::vector<ListItem> GetLoadedModListItems(CModResults const& loadedMods, std::string_view path, bool sortByStartupCost) {
+    std::vector<ListItem> result;
+    std::vector<std::pair<int, size_t>> startupCosts;
+
+    for (size_t i = 0; i < loadedMods.size; i++) {
+        CModResult const& mod = loadedMods.array[i];
+
+        if (!std::string_view(mod.path).starts_with(path)) {
+            continue;
+        }
+
+        Logger.info("Adding mod {}", mod.info.id);
+        std::string_view id = strlen(mod.info.id) == 0 ? mod.path : mod.info.id;
+        if (auto slash = id.find_last_of('/'); slash != std::string_view::npos) {
+            id = id.substr(slash + 1);
+        }
+        ListItem item{fmt::format("<color=green>{}</color><color=white> v{}", id, strlen(mod.info.version) == 0 ? "0.0.0" : mod.info.version), {}, {}};
+
+        // Show how many errors and warnings the mod logged, the last few errors are read when hovering
+        if (auto log = GetModLogSummary(mod.info.id)) {
+            if (log->errors > 0) {
+                fmt::format_to(std::back_inserter(item.content), " <color=red>{}E", log->errors);
+                item.lazyHoverHint = [modId = std::string(mod.info.id)]() {
+                    return GetRecentModErrors(modId);
+                };
+            }
+            if (log->warnings > 0) {
+                fmt::format_to(std::back_inserter(item.content), " <color=yellow>{}W", log->warnings);
+            }
+            item.hoverHint = fmt::format("{} errors and {} warnings logged this session", log->errors, log->warnings);
+        }
+
+        // Add the estimated startup cost, shown in the row when sorting by it
+        if (auto cost = GetStartupCost(mod.path)) {
+            item.hoverHint = fmt::format("Estimated startup cost: {}/100{}{}", *cost, item.hoverHint.empty() ? "" : "\n", item.hoverHint);
+            if (sortByStartupCost) {
+                item.content = fmt::format("<color=#A0A0A0>{:>3}</color> {}", *cost, item.content);
+            }
+            startupCosts.emplace_back(*cost, result.size());
+        } else {
+            startupCosts.emplace_back(-1, result.size());
+        }
+        result.push_back(std::move(item));
+    }
+
+    if (sortByStartupCost) {
+        std::stable_sort(startupCosts.begin(), startupCosts.end(), [](auto const& a, auto const& b) {
+            return a.first > b.first;
+        });
+
+        std::vector<ListItem> sorted;
+        sorted.reserve(result.size());
+        for (auto const& [cost, index] : startupCosts) {
+            sorted.push_back(std::move(result[index]));
+        }
+        return sorted;
+    }
+
+    return result;
+}
@@ -0,0 +1,248 @@
+#include "list_view.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <optional>
+#include <utility>
+
+#include "boot_history.hpp"
+#include "fmt/format.h"
+#include "integrity.hpp"
+#include "library_utils.hpp"
+#include "log_index.hpp"
+#include "logger.hpp"
+#include "scotland2/shared/modloader.h"
+
+// UnityEngine
+#include "UnityEngine/Canvas.hpp"
+#include "UnityEngine/RectOffset.hpp"
+#include "UnityEngine/TextAnchor.hpp"
+using namespace UnityEngine;
+
+// UnityEngine::UI
+#include "UnityEngine/UI/LayoutElement.hpp"
+using namespace UnityEngine::UI;
+
+// BSML
+#include "bsml/shared/Helpers/utilities.hpp"
+using namespace BSML;
+using namespace BSML::Lite;
+
+// TMPro
+#include "TMPro/TextAlignmentOptions.hpp"
+#include "TMPro/TextMeshProUGUI.hpp"
+using namespace TMPro;
+
+/// @brief The text of a lazy hover hint, until it is first shown.
+struct LazyHoverHint {
+    std::string baseText;
+    std::function<std::optional<std::string>()> details;
+};
+
+static std::unordered_map<HMUI::HoverHint*, LazyHoverHint> lazyHoverHints;
+
+void SetLazyHoverHint(HMUI::HoverHint* hoverHint, std::string baseText, std::function<std::optional<std::string>()> details) {
+    lazyHoverHints[hoverHint] = {std::move(baseText), std::move(details)};
+}
+
+void ResolveLazyHoverHint(HMUI::HoverHint* hoverHint) {
+    auto lazy = lazyHoverHints.extract(hoverHint);
+    if (lazy.empty()) {
+        return;
+    }
+
+    std::optional<std::string> details = lazy.mapped().details();
+    if (!details.has_value()) {
+        // Not known yet, ask again the next time the hover hint is shown
+        lazyHoverHints.insert(std::move(lazy));
+    } else if (!details->empty()) {
+        auto const& baseText = lazy.mapped().baseText;
+        hoverHint->set_text(baseText.empty() ? *details : fmt::format("{}\n{}", baseText, *details));
+    }
+}
+
+void ClearLazyHoverHints() {
+    lazyHoverHints.clear();
+}
+
+void CreateListWithTitle(
+    TransformWrapper parent,
+    TransformWrapper titleParent,
+    float columnWidth,
+    std::string title,
+    std::vector<ListItem> const& content,
+    std::string const& titleHoverHint
+) {
+    VerticalLayoutGroup* layout = CreateVerticalLayoutGroup(parent);
+    // layout->name = title;
+    layout->set_spacing(0.5);
+    layout->set_childAlignment(UnityEngine::TextAnchor::UpperLeft);
+    layout->set_childForceExpandHeight(false);
+    layout->set_childControlHeight(true);
+
+    // Create a layout for displaying the title.
+    VerticalLayoutGroup* titleLayout = CreateVerticalLayoutGroup(titleParent);
+    titleLayout->name = "TitleWrapper";
+    titleLayout->set_childForceExpandHeight(false);
+    titleLayout->set_childControlHeight(true);
+    titleLayout->GetComponent<LayoutElement*>()->set_minWidth(columnWidth);  // Make sure the list has a set width.
+    titleLayout->GetComponent<LayoutElement*>()->set_preferredWidth(columnWidth);
+    titleLayout->set_padding(UnityEngine::RectOffset::New_ctor(0, 0, 0, 0));
+
+    // Create the title text
+    auto titleText = CreateText(titleLayout->get_rectTransform(), title);
+    titleText->name = "TitleText";
+    titleText->set_alignment(TMPro::TextAlignmentOptions::BottomLeft);
+    titleText->set_overflowMode(TMPro::TextOverflowModes::Ellipsis);
+    if (!titleHoverHint.empty()) {
+        AddHoverHint(titleText->get_gameObject(), titleHoverHint);
+    }
+
+    // Create a layout for the list itself
+    VerticalLayoutGroup* listLayout = CreateVerticalLayoutGroup(layout->get_rectTransform());
+    listLayout->name = "ModsVerticalLayout";
+    listLayout->GetComponent<LayoutElement*>()->set_minWidth(columnWidth);  // Make sure the list has a set width.
+    listLayout->GetComponent<LayoutElement*>()->set_preferredWidth(columnWidth);
+    listLayout->set_padding(UnityEngine::RectOffset::New_ctor(1, 1, 1, 1));
+    listLayout->set_childAlignment(UnityEngine::TextAnchor::UpperLeft);
+    listLayout->set_childForceExpandHeight(false);
+    listLayout->set_childControlHeight(true);
+
+    // Create a line of text for each in the list
+    for (auto const& element : content) {
+        TMPro::TextMeshProUGUI* text = CreateText(listLayout->get_rectTransform(), element.content);
+        text->name = "ModText";
+        text->GetComponent<LayoutElement*>()->set_preferredWidth(columnWidth);
+        text->set_overflowMode(TMPro::TextOverflowModes::Ellipsis);
+
+        // Add a hover hint if there is one, the lazy part is only built when it is shown
+        if (!element.hoverHint.empty() || element.lazyHoverHint) {
+            auto hoverHint = AddHoverHint(text->get_gameObject(), element.hoverHint);
+            if (element.lazyHoverHint) {
+                SetLazyHoverHint(hoverHint, element.hoverHint, element.lazyHoverHint);
+            }
+        }
+        text->set_fontSize(2.3f);
+    }
+}
+
+void CreateModLists(TransformWrapper parent, TransformWrapper titleParent, bool sortByStartupCost) {
+    // Check to see which libraries loaded/failed to load
+    Logger.info("Checking library load info.");
+    std::vector<ListItem> librariesList = GetLibraryListItems(GetModloaderLibsLoadInfo(), "libs");
+
+    // Catch up on the log, so each mod can show what it logged
+    UpdateLogIndex();
+
+    // Populate the lists of all loaded mods and early mods
+    Logger.info("Adding loaded mods . . .");
+    auto modloaderLoadedMods = modloader_get_loaded();
+    std::string filesDir = modloader_get_files_dir();
+    std::vector<ListItem> loadedMods = GetLoadedModListItems(modloaderLoadedMods, filesDir + "/mods", sortByStartupCost);
+    std::vector<ListItem> loadedEarlyMods = GetLoadedModListItems(modloaderLoadedMods, filesDir + "/early_mods", sortByStartupCost);
+
+    // Populate the lists of all failed mods and early mods
+    Logger.info("Checking for failed mods . . .");
+    std::vector<ListItem> failedMods = GetFailedListItems(GetModsLoadInfo(), "mods", GetPreviousBoots());
+    std::vector<ListItem> failedEarlyMods = GetFailedListItems(GetEarlyModsLoadInfo(), "early_mods", GetPreviousBoots());
+
+    // Create lists for each group
+    CreateListWithTitle(parent, titleParent, 31.5, "Loaded Early Mods", loadedEarlyMods);
+    CreateListWithTitle(parent, titleParent, 31.5, "Loaded Mods", loadedMods, GetBootHistorySummary());
+    CreateListWithTitle(parent, titleParent, 31.5, "Failed Early Mods", failedEarlyMods);
+    CreateListWithTitle(parent, titleParent, 31.5, "Failed Mods", failedMods);
+    CreateListWithTitle(parent, titleParent, 31.5, "Libraries", librariesList);
+}
+
+RectTransform* createCanvas(TransformWrapper parent, Vector2 sizeDelta, Vector2 anchoredPosition) {
+    auto canvas = BSML::Lite::CreateCanvas();
+    auto rectTransform = canvas->GetComponent<UnityEngine::RectTransform*>();
+
+    rectTransform->SetParent(parent, false);
+    rectTransform->localScale = {1, 1, 1};
+    rectTransform->sizeDelta = sizeDelta;
+    rectTransform->anchoredPosition = anchoredPosition;
+    rectTransform->GetComponent<UnityEngine::Canvas*>()->set_overrideSorting(true);
+
+    return rectTransform;
+}
+
+HMUI::ImageView* drawLine(TransformWrapper parent, Vector2 const start, Vector2 const end, float thickness) {
+    static auto whitePixel = BSML::Utilities::ImageResources::GetWhitePixel();
+
+    Vector2 start2 = {start.x, -start.y};
+    Vector2 end2 = {end.x, -end.y};
+
+    // Manually compute the difference vector.
+    Vector2 diff;
+    diff.x = end2.x - start2.x;
+    diff.y = end2.y - start2.y;
+
+    // Compute the distance between the two points.
+    float distance = std::hypot(diff.x, diff.y);
+
+    auto pixelImage = BSML::Lite::CreateImage(parent, whitePixel, {0, 0}, {0, 0});
+    auto pixelRect = pixelImage->rectTransform;
+
+    pixelRect->pivot = {0, 0};
+    pixelRect->anchorMin = {0, 1};
+    pixelRect->anchorMax = {0, 1};
+    pixelRect->anchoredPosition = start2;
+
+    // Set the size: width equals the distance, height equals the thickness.
+    pixelRect->sizeDelta = {distance, thickness};
+
+    // Compute the angle (in degrees) between the start and end points.
+    // Note: std::atan2 returns radians.
+    float angle = std::atan2(diff.y, diff.x) * 180.0f / 3.14159265f;
+
+    // Rotate the element so it aligns with the line direction.
+    pixelRect->localEulerAngles = {0.0f, 0.0f, angle};
+
+    return pixelImage;
+}
+
+void drawFailedList(
+    VerticalLayoutGroup* layout, std::unordered_map<std::string, std::string> const& failedMods, std::string const& title, std::string_view directory
+) {
+    // Rows only get the integrity problem of their file once the scan is done, it is not waited for
+    bool integrityPending = !directory.empty() && !WaitForIntegrityScan(std::chrono::milliseconds(0));
+
+    if (failedMods.size() > 0) {
+        // Create the title text for the failed mods
+        TextMeshProUGUI* modsTitleText = Lite::CreateText(layout, title);
+        modsTitleText->set_fontSize(5.0f);
+        modsTitleText->set_alignment(TextAlignmentOptions::Top);
+        modsTitleText->get_transform().cast<RectTransform>()->set_sizeDelta({70, 4});
+
+        auto separator = Lite::CreateText(layout, "_____________________________________________________________________________________________");
+        separator->set_alignment(TextAlignmentOptions::Bottom);
+        separator->get_transform().cast<RectTransform>()->set_sizeDelta({70, 4});
+        separator->set_overflowMode(TextOverflowModes::Overflow);
+        ;
+
+        // Add the failed mods to the GUI
+        for (auto const& failedMod : failedMods) {
+            TextMeshProUGUI* modText = Lite::CreateText(layout, fmt::format("<color=red>{}</color>", failedMod.first.c_str()));
+            modText->set_overflowMode(TextOverflowModes::Overflow);
+            modText->set_fontSize(3.5f);
+            modText->set_alignment(TextAlignmentOptions::Top);
+            modText->get_transform().cast<RectTransform>()->get_transform().cast<RectTransform>()->set_sizeDelta({70, 3.5});
+
+            auto hoverHint = Lite::AddHoverHint(
+                modText, failedMod.second
+            );  // Show the full fail reason in a hover hint, since there most likely won't be enough space in the modal view
+            if (integrityPending) {
+                SetLazyHoverHint(hoverHint, failedMod.second, [directory = std::string(directory), name = failedMod.first]() -> std::optional<std::string> {
+                    if (!WaitForIntegrityScan(std::chrono::milliseconds(0))) {
+                        return std::nullopt;
+                    }
+                    auto issue = GetIntegrityIssue(directory, name);
+                    return issue ? *issue : std::string();
+                });
+            }
+        }
+
+        Lite::CreateText(layout, " ")->get_transform().cast<RectTransform>()->set_sizeDelta({70, 1});
+    }
+}
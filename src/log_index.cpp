@@ -0,0 +1,231 @@
+#include "log_index.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "fmt/format.h"
+#include "logger.hpp"
+#include "scotland2/shared/modloader.h"
+
+static constexpr size_t recentErrorCount = 3;
+static constexpr size_t maxErrorLineLength = 200;
+static constexpr size_t maxTagSearchLength = 96;
+
+/// @brief The location of a line in the log file.
+struct LogLine {
+    uint64_t offset;
+    uint32_t length;
+};
+
+/// @brief The warnings and errors of a single logging tag.
+struct TagIndex {
+    uint32_t warnings = 0;
+    uint32_t errors = 0;
+    /// @brief A ring of the last error lines, nextRecentError is the oldest.
+    std::array<LogLine, recentErrorCount> recentErrors{};
+    uint32_t nextRecentError = 0;
+};
+
+/// @brief Allows looking up tags by string_view without allocating.
+struct TagHash {
+    using is_transparent = void;
+
+    size_t operator()(std::string_view tag) const {
+        return std::hash<std::string_view>{}(tag);
+    }
+};
+
+static std::unordered_map<std::string, TagIndex, TagHash, std::equal_to<>> tagIndex;
+static uint64_t indexedBytes = 0;
+static ino_t indexedInode = 0;
+
+static std::string const& GetLogPath() {
+    static std::string path = fmt::format("{}/../logs2/PaperLog.log", modloader_get_files_dir());
+    return path;
+}
+
+/// @brief Adds a single line, without its newline, to the index.
+static void IndexLine(std::string_view line, uint64_t offset) {
+    std::string_view head = line.substr(0, maxTagSearchLength);
+
+    // The level is the first word that is not a timestamp, only warnings and errors are indexed
+    size_t levelStart = head.find_first_not_of(" [");
+    while (levelStart != std::string_view::npos && head[levelStart] >= '0' && head[levelStart] <= '9') {
+        levelStart = head.find_first_not_of(" [", head.find_first_of(' ', levelStart));
+    }
+    if (levelStart == std::string_view::npos) {
+        return;
+    }
+    bool isError = head[levelStart] == 'E' || head[levelStart] == 'C';
+    bool isWarning = head[levelStart] == 'W';
+    if (!isError && !isWarning) {
+        return;
+    }
+
+    // The tag is the first bracketed word after the level
+    size_t tagStart = head.find('[', head.find_first_of(" ]", levelStart));
+    size_t tagEnd = head.find(']', tagStart);
+    if (tagStart == std::string_view::npos || tagEnd == std::string_view::npos) {
+        return;
+    }
+    std::string_view tag = head.substr(tagStart + 1, tagEnd - tagStart - 1);
+
+    auto index = tagIndex.find(tag);
+    if (index == tagIndex.end()) {
+        index = tagIndex.emplace(std::string(tag), TagIndex()).first;
+    }
+
+    if (isWarning) {
+        index->second.warnings++;
+        return;
+    }
+
+    index->second.errors++;
+    index->second.recentErrors[index->second.nextRecentError] = {offset, static_cast<uint32_t>(std::min(line.size(), maxErrorLineLength))};
+    index->second.nextRecentError = (index->second.nextRecentError + 1) % recentErrorCount;
+}
+
+void UpdateLogIndex() {
+    auto start = std::chrono::steady_clock::now();
+
+    int fd = open(GetLogPath().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return;
+    }
+
+    // Start over if the log was replaced or truncated
+    uint64_t size = st.st_size;
+    if (st.st_ino != indexedInode || size < indexedBytes) {
+        tagIndex.clear();
+        indexedBytes = 0;
+        indexedInode = st.st_ino;
+    }
+
+    if (size == indexedBytes) {
+        close(fd);
+        return;
+    }
+
+    // Only map the part of the file that has not been indexed yet
+    uint64_t pageSize = sysconf(_SC_PAGESIZE);
+    uint64_t mapStart = indexedBytes & ~(pageSize - 1);
+    size_t mapSize = size - mapStart;
+    void* mapping = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, mapStart);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        Logger.warn("Failed to map log file");
+        return;
+    }
+    madvise(mapping, mapSize, MADV_SEQUENTIAL);
+
+    char const* base = static_cast<char const*>(mapping);
+    char const* line = base + (indexedBytes - mapStart);
+    char const* end = base + mapSize;
+    while (line < end) {
+        auto newline = static_cast<char const*>(std::memchr(line, '\n', end - line));
+        if (!newline) {
+            // Leave the incomplete last line for the next update
+            break;
+        }
+
+        IndexLine({line, static_cast<size_t>(newline - line)}, mapStart + (line - base));
+        line = newline + 1;
+    }
+
+    uint64_t previousBytes = indexedBytes;
+    indexedBytes = mapStart + (line - base);
+    munmap(mapping, mapSize);
+
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Logger.debug("Indexed {} bytes of log in {:.2f} ms", indexedBytes - previousBytes, elapsed);
+}
+
+/// @brief Whether a logging tag is the mod id, or the mod id followed by "_" and a version.
+static bool IsModTag(std::string_view tag, std::string_view modId) {
+    if (!tag.starts_with(modId)) {
+        return false;
+    }
+    if (tag.size() == modId.size()) {
+        return true;
+    }
+    return tag.size() > modId.size() + 1 && tag[modId.size()] == '_' && tag[modId.size() + 1] >= '0' && tag[modId.size() + 1] <= '9';
+}
+
+std::optional<ModLogSummary> GetModLogSummary(std::string_view modId) {
+    if (modId.empty()) {
+        return std::nullopt;
+    }
+
+    ModLogSummary summary{};
+    for (auto const& [tag, index] : tagIndex) {
+        if (IsModTag(tag, modId)) {
+            summary.warnings += index.warnings;
+            summary.errors += index.errors;
+        }
+    }
+
+    if (summary.warnings == 0 && summary.errors == 0) {
+        return std::nullopt;
+    }
+    return summary;
+}
+
+std::string GetRecentModErrors(std::string_view modId) {
+    if (modId.empty()) {
+        return {};
+    }
+
+    std::vector<LogLine> errorLines;
+    for (auto const& [tag, index] : tagIndex) {
+        if (!IsModTag(tag, modId)) {
+            continue;
+        }
+        for (auto const& errorLine : index.recentErrors) {
+            if (errorLine.length > 0) {
+                errorLines.push_back(errorLine);
+            }
+        }
+    }
+
+    // Read the newest error lines back from the log
+    std::sort(errorLines.begin(), errorLines.end(), [](LogLine const& a, LogLine const& b) {
+        return a.offset < b.offset;
+    });
+    if (errorLines.size() > recentErrorCount) {
+        errorLines.erase(errorLines.begin(), errorLines.end() - recentErrorCount);
+    }
+
+    std::string recentErrors;
+    int fd = errorLines.empty() ? -1 : open(GetLogPath().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        char buffer[maxErrorLineLength];
+        for (auto const& errorLine : errorLines) {
+            ssize_t read = pread(fd, buffer, errorLine.length, errorLine.offset);
+            if (read > 0) {
+                if (!recentErrors.empty()) {
+                    recentErrors += '\n';
+                }
+                recentErrors.append(buffer, read);
+            }
+        }
+        close(fd);
+    }
+
+    return recentErrors;
+}
@@ -1,10 +1,14 @@
 #include "main.hpp"
 
 #include "autohooks/shared/hooks.hpp"
+#include "boot_history.hpp"
 #include "bsml/shared/BSML.hpp"
 #include "config.hpp"
+#include "integrity.hpp"
+#include "library_usage.hpp"
 #include "logger.hpp"
 #include "modInfo.hpp"
+#include "startup_cost.hpp"
 #include "ModListViewController.hpp"
 using namespace ModList;
 
@@ -12,6 +16,9 @@ using namespace ModList;
 /// @param info The mod info.  Update this with your mod's info.
 /// @return
 MOD_EXPORT_FUNC void setup(CModInfo& info) {
+    // Start timing this boot for the boot history
+    MarkBootStart();
+
     // Convert the mod info to a C struct and set that as the modloader info.
     info = modInfo.to_c();
 
@@ -47,6 +54,15 @@ MOD_EXPORT_FUNC void late_load() {
     BSML::Register::RegisterMainMenu<ModListViewController*>("Loaded Mods", "Loaded Mods", "View Loaded Mods");
     BSML::Register::RegisterSettingsMenu("Mod List", ConfigViewDidActivate, true);
 
+    // Check the installed files for truncation and corruption in the background
+    StartIntegrityScan();
+
+    // Find the libraries no mod needs anymore
+    StartLibraryUsageAnalysis();
+
+    // Estimate how much each mod adds to the boot time
+    StartStartupCostEstimate();
+
     // Get the number of late hooks that will be installed.
     auto lateHookCount = LATE_HOOK_COUNT;
 
@@ -0,0 +1,62 @@
+#include "sprite_cache.hpp"
+
+#include <cstring>
+#include <span>
+#include <unordered_map>
+
+#include "beatsaber-hook/shared/utils/typedefs-wrappers.hpp"
+#include "bsml/shared/Helpers/utilities.hpp"
+#include "logger.hpp"
+#include "UnityEngine/HideFlags.hpp"
+#include "UnityEngine/Texture2D.hpp"
+#include "UnityEngine/TextureFormat.hpp"
+
+static constexpr uint32_t rawTextureFormatRGBA32 = 0;
+
+/// @brief Uploads a pre-decoded texture straight from the embedded pixels, returns nullptr if it is not usable.
+static UnityEngine::Sprite* LoadRawSprite(PredecodedAsset const& asset) {
+    if (std::memcmp(asset.header.magic, "RTEX", 4) != 0 || asset.header.format != rawTextureFormatRGBA32) {
+        return nullptr;
+    }
+
+    ArrayW<uint8_t> pixels = asset.pixels;
+    if (pixels.size() < size_t(asset.header.width) * asset.header.height * 4) {
+        Logger.error("Pre-decoded texture is truncated");
+        return nullptr;
+    }
+
+    auto texture = UnityEngine::Texture2D::New_ctor(asset.header.width, asset.header.height, UnityEngine::TextureFormat::RGBA32, false);
+    texture->LoadRawTextureData(pixels);
+    texture->Apply(false, true);  // Upload, and drop the CPU copy of the pixels
+
+    return BSML::Utilities::LoadSpriteFromTexture(texture);
+}
+
+UnityEngine::Sprite* GetCachedSprite(IncludedAsset const& asset) {
+    static std::unordered_map<uint8_t const*, SafePtrUnity<UnityEngine::Sprite>> sprites;
+
+    std::span<uint8_t> data = asset;
+    auto cached = sprites.find(data.data());
+    if (cached != sprites.end() && cached->second) {
+        return cached->second.ptr();
+    }
+
+    UnityEngine::Sprite* sprite = nullptr;
+    for (auto const& predecoded : GetPredecodedAssets()) {
+        if (std::span<uint8_t>(predecoded.png).data() == data.data()) {
+            sprite = LoadRawSprite(predecoded);
+            break;
+        }
+    }
+    if (!sprite) {
+        sprite = PNG_SPRITE(asset);
+    }
+    if (!sprite) {
+        return nullptr;
+    }
+
+    // Keep the sprite around when unused assets are unloaded, it is cached
+    sprite->hideFlags = UnityEngine::HideFlags::DontUnloadUnusedAsset;
+    sprites[data.data()] = sprite;
+    return sprite;
+}
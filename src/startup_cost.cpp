@@ -0,0 +1,121 @@
+#include "startup_cost.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include "integrity.hpp"
+#include "logger.hpp"
+#include "scotland2/shared/modloader.h"
+
+/// @brief The result of the estimate.
+struct StartupCosts {
+    /// @brief The scaled cost of every mod, keyed by path.
+    std::unordered_map<std::string, int> costs;
+    /// @brief The cost of the most expensive mod, which scores 100.
+    double maxCost;
+};
+
+static std::shared_future<StartupCosts> startupCostEstimate;
+
+// Relative weights of the work the dynamic linker and the mod's constructors do while loading
+static constexpr double costPerSymbolRelocation = 1.0;
+static constexpr double costPerRelativeRelocation = 0.05;
+static constexpr double costPerUndefinedSymbol = 0.5;
+static constexpr double costPerConstructor = 25.0;
+static constexpr double costPerMappedMiB = 50.0;
+
+double EstimateStartupCost(ElfLibraryInfo const& info) {
+    uint64_t relativeRelocations = std::min(info.relativeRelocationCount, info.relocationCount);
+    uint64_t symbolRelocations = info.relocationCount - relativeRelocations;
+
+    return symbolRelocations * costPerSymbolRelocation + relativeRelocations * costPerRelativeRelocation +
+           info.undefinedSymbolCount * costPerUndefinedSymbol + info.initArrayCount * costPerConstructor +
+           info.mappedSize / (1024.0 * 1024.0) * costPerMappedMiB;
+}
+
+static StartupCosts RunStartupCostEstimate(std::string filesDir, std::vector<std::string> paths, std::shared_future<ScannedLibraries> scannedLibraries) {
+    auto const& scanned = scannedLibraries.get();
+    auto start = std::chrono::steady_clock::now();
+
+    // The integrity scan read every library already, look the mods up by their path relative to the files dir
+    std::vector<double> costs(paths.size(), -1);
+    double maxCost = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        std::string_view path = paths[i];
+        if (!path.starts_with(filesDir) || path.size() <= filesDir.size() || path[filesDir.size()] != '/') {
+            continue;
+        }
+
+        auto info = scanned.find(std::string(path.substr(filesDir.size() + 1)));
+        if (info != scanned.end()) {
+            costs[i] = EstimateStartupCost(info->second);
+            maxCost = std::max(maxCost, costs[i]);
+        }
+    }
+
+    // Scale the costs so the most expensive mod scores 100
+    StartupCosts result{{}, maxCost};
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (costs[i] >= 0) {
+            result.costs.emplace(std::move(paths[i]), maxCost > 0 ? static_cast<int>(std::lround(costs[i] / maxCost * 100)) : 0);
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    Logger.info("Estimated the startup cost of {} mods in {} ms", result.costs.size(), elapsed);
+
+    return result;
+}
+
+void StartStartupCostEstimate() {
+    if (startupCostEstimate.valid()) {
+        return;
+    }
+
+    std::vector<std::string> paths;
+    auto loadedMods = modloader_get_loaded();
+    for (size_t i = 0; i < loadedMods.size; i++) {
+        paths.emplace_back(loadedMods.array[i].path);
+    }
+
+    // The integrity scan already maps every library, use what it read instead of mapping them again
+    StartIntegrityScan();
+    try {
+        startupCostEstimate =
+            std::async(std::launch::async, RunStartupCostEstimate, std::string(modloader_get_files_dir()), std::move(paths), GetScannedLibraries()).share();
+    } catch (std::system_error const& e) {
+        // Finish with no estimates, the getters run on the UI thread and must not throw
+        Logger.error("Failed to start startup cost estimate: {}", e.what());
+        std::promise<StartupCosts> noCosts;
+        noCosts.set_value({{}, 0});
+        startupCostEstimate = noCosts.get_future().share();
+    }
+}
+
+std::optional<int> GetStartupCost(std::string_view path) {
+    if (!startupCostEstimate.valid() || startupCostEstimate.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return std::nullopt;
+    }
+
+    auto const& costs = startupCostEstimate.get().costs;
+    auto cost = costs.find(std::string(path));
+    if (cost == costs.end()) {
+        return std::nullopt;
+    }
+    return cost->second;
+}
+
+std::optional<int> ScaleStartupCost(double cost) {
+    if (!startupCostEstimate.valid() || startupCostEstimate.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return std::nullopt;
+    }
+
+    double maxCost = startupCostEstimate.get().maxCost;
+    return maxCost > 0 ? static_cast<int>(std::lround(cost / maxCost * 100)) : 0;
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "boot_history.hpp"
+#include "fmt/format.h"
+#include "list_items.hpp"
+#include "scotland2/shared/modloader.h"
+#include "test_utils.hpp"
+
+static BootRecord MakeBoot(uint32_t sequence, std::vector<std::string> const& failures) {
+    BootRecord record{};
+    record.sequence = sequence;
+    record.timestamp = 1700000000 + sequence * 86400;
+    record.loadedMods = 10;
+    record.failedMods = failures.size();
+    for (auto const& name : failures) {
+        record.failureHashes[record.failureCount++] = HashLibraryName(name);
+    }
+    return record;
+}
+
+static std::string GetHistoryPath() {
+    return fmt::format("{}/{}_boot_history.bin", modloader_get_files_dir(), MOD_ID);
+}
+
+/// @brief Builds a history file in the format RecordCurrentBoot() writes.
+static std::string MakeHistoryFile(std::vector<BootRecord> const& records) {
+    struct {
+        uint32_t magic = 0x544F4F42;
+        uint16_t version = 1;
+        uint16_t recordSize = sizeof(BootRecord);
+        uint32_t capacity = 64;
+        uint32_t reserved = 0;
+    } header;
+
+    std::string contents(reinterpret_cast<char const*>(&header), sizeof(header));
+    for (auto const& record : records) {
+        contents.append(reinterpret_cast<char const*>(&record), sizeof(record));
+    }
+    return contents;
+}
+
+static ListItem const& FindItem(std::vector<ListItem> const& items, std::string_view name) {
+    auto item = std::find_if(items.begin(), items.end(), [&](ListItem const& item) {
+        return item.content.starts_with("<color=red>" + std::string(name));
+    });
+    EXPECT_NE(item, items.end()) << name;
+    return *item;
+}
+
+TEST(BootHistoryTest, FailuresAreComparedWithTheLastGoodBoot) {
+    std::vector<BootRecord> boots = {MakeBoot(1, {"a.so"}), MakeBoot(2, {}), MakeBoot(3, {"b.so"}), MakeBoot(4, {"b.so", "c.so"})};
+    LibraryLoadInfo loadInfo = {{"a.so", "a failed"}, {"b.so", "b failed"}, {"c.so", "c failed"}, {"d.so", "d failed"}};
+
+    auto items = GetFailedListItems(loadInfo, "mods", boots);
+    ASSERT_EQ(items.size(), 4);
+
+    // Everything failing now loaded in boot 2, including a.so which failed before it
+    for (auto name : {"a.so", "b.so", "c.so", "d.so"}) {
+        auto const& item = FindItem(items, name);
+        EXPECT_TRUE(item.content.ends_with("(new)")) << name;
+        EXPECT_NE(item.hoverHint.find(fmt::format("loaded in the last good boot ({})", FormatBootTime(boots[1]))), std::string::npos);
+    }
+    EXPECT_TRUE(FindItem(items, "a.so").hoverHint.starts_with("Failing since this boot"));
+    EXPECT_TRUE(FindItem(items, "b.so").hoverHint.starts_with("Failing since " + FormatBootTime(boots[2])));
+    EXPECT_TRUE(FindItem(items, "c.so").hoverHint.starts_with("Failing since " + FormatBootTime(boots[3])));
+    EXPECT_TRUE(FindItem(items, "d.so").hoverHint.starts_with("Failing since this boot"));
+    EXPECT_TRUE(FindItem(items, "d.so").hoverHint.ends_with("d failed"));
+}
+
+TEST(BootHistoryTest, WithoutAGoodBootTheOldestBootIsTheBaseline) {
+    std::vector<BootRecord> boots = {MakeBoot(1, {"a.so"}), MakeBoot(2, {"a.so", "b.so"})};
+    LibraryLoadInfo loadInfo = {{"a.so", "a failed"}, {"b.so", "b failed"}};
+
+    auto items = GetFailedListItems(loadInfo, "mods", boots);
+    EXPECT_FALSE(FindItem(items, "a.so").content.ends_with("(new)"));
+    EXPECT_TRUE(FindItem(items, "a.so").hoverHint.starts_with("Already failing in the oldest boot kept"));
+    EXPECT_TRUE(FindItem(items, "b.so").content.ends_with("(new)"));
+    EXPECT_TRUE(FindItem(items, "b.so").hoverHint.starts_with("Failing since " + FormatBootTime(boots[1])));
+}
+
+TEST(BootHistoryTest, IncompleteFailureListsAreNotCompared) {
+    BootRecord overflowing = MakeBoot(1, {});
+    overflowing.failedMods = BootRecord::MaxFailures + 1;
+    LibraryLoadInfo loadInfo = {{"a.so", "a failed"}};
+
+    auto items = GetFailedListItems(loadInfo, "mods", {overflowing});
+    ASSERT_EQ(items.size(), 1);
+    EXPECT_EQ(items[0].content, "<color=red>a.so");
+    EXPECT_EQ(items[0].hoverHint, "a failed");
+}
+
+TEST(BootHistoryTest, ValidHistoryIsAppendedInPlace) {
+    ExpectInFreshProcess([] {
+        std::vector<BootRecord> boots = {MakeBoot(1, {}), MakeBoot(2, {"a.so"}), MakeBoot(3, {})};
+        WriteFile(GetHistoryPath(), MakeHistoryFile(boots));
+
+        ASSERT_EQ(GetPreviousBoots().size(), 3);
+        RecordCurrentBoot();
+
+        std::string contents = ReadFile(GetHistoryPath());
+        ASSERT_EQ(contents.size(), 16 + 4 * sizeof(BootRecord));
+        EXPECT_EQ(contents.substr(0, 16 + 3 * sizeof(BootRecord)), MakeHistoryFile(boots));
+
+        BootRecord recorded;
+        std::memcpy(&recorded, contents.data() + 16 + 3 * sizeof(BootRecord), sizeof(recorded));
+        EXPECT_EQ(recorded.sequence, 4);
+    });
+}
+
+TEST(BootHistoryTest, InvalidHistoryIsRecreated) {
+    ExpectInFreshProcess([] {
+        WriteFile(GetHistoryPath(), std::string(200, 'x'));
+
+        EXPECT_TRUE(GetPreviousBoots().empty());
+        RecordCurrentBoot();
+
+        std::string contents = ReadFile(GetHistoryPath());
+        ASSERT_EQ(contents.size(), 16 + sizeof(BootRecord));
+        EXPECT_EQ(contents.substr(0, 16), MakeHistoryFile({}));
+    });
+}
+
+TEST(BootHistoryTest, UnreadableHistoryIsLeftAlone) {
+    ExpectInFreshProcess([] {
+        // A directory opens and stats fine but cannot be mapped, like a file on a failing filesystem
+        std::filesystem::create_directory(GetHistoryPath());
+        WriteFile(GetHistoryPath() + "/keep", "history");
+
+        EXPECT_TRUE(GetPreviousBoots().empty());
+        RecordCurrentBoot();
+
+        EXPECT_TRUE(std::filesystem::is_directory(GetHistoryPath()));
+        EXPECT_EQ(ReadFile(GetHistoryPath() + "/keep"), "history");
+    });
+}
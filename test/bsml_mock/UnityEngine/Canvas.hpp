@@ -0,0 +1,3 @@
+#pragma once
+
+#include "bsml_mock.hpp"
@@ -0,0 +1,424 @@
+#pragma once
+
+// Host stand-ins for the parts of Unity, TMPro, HMUI and BSML::Lite the UI code uses.
+//
+// Every game object, component and string the UI creates is counted, so tests can check what building a view costs.
+// The components added by each BSML::Lite call mirror what BSML adds in the game.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BSMLMock {
+struct Counters {
+    /// @brief The number of game objects created.
+    size_t objects = 0;
+    /// @brief The number of components added to them, including their transforms.
+    size_t components = 0;
+    /// @brief The bytes of text, names and hover hints stored in them.
+    size_t stringBytes = 0;
+};
+
+inline Counters counters;
+}  // namespace BSMLMock
+
+namespace UnityEngine {
+struct Vector2 {
+    constexpr Vector2(float x = 0, float y = 0) : x(x), y(y) {}
+    float x;
+    float y;
+};
+
+struct Vector3 {
+    constexpr Vector3(float x = 0, float y = 0, float z = 0) : x(x), y(y), z(z) {}
+    float x;
+    float y;
+    float z;
+};
+
+enum class TextAnchor {
+    UpperLeft,
+    UpperCenter,
+    UpperRight,
+    MiddleLeft,
+    MiddleCenter,
+    MiddleRight,
+};
+
+/// @brief A string stored in a Unity object, counted when assigned.
+struct CountedString {
+    CountedString& operator=(std::string_view newValue) {
+        BSMLMock::counters.stringBytes += newValue.size();
+        value = newValue;
+        return *this;
+    }
+
+    std::string value;
+};
+
+struct Object {
+    virtual ~Object() = default;
+
+    CountedString name;
+};
+
+struct Sprite : Object {};
+
+struct RectOffset : Object {
+    static RectOffset* New_ctor(int left, int right, int top, int bottom);
+
+    int left = 0;
+    int right = 0;
+    int top = 0;
+    int bottom = 0;
+};
+
+struct GameObject;
+struct Transform;
+}  // namespace UnityEngine
+
+/// @brief A checked pointer to a Unity object, as returned by the generated getters.
+template <typename T>
+struct UnityW {
+    UnityW(T* ptr) : ptr(ptr) {}
+
+    T* operator->() const {
+        return ptr;
+    }
+    operator T*() const {
+        return ptr;
+    }
+
+    template <typename U>
+    U* cast() const {
+        return dynamic_cast<U*>(ptr);
+    }
+
+    T* ptr;
+};
+
+namespace UnityEngine {
+struct Component : Object {
+    GameObject* get_gameObject() const {
+        return gameObject;
+    }
+    UnityW<Transform> get_transform() const;
+
+    template <typename T>
+    T GetComponent() const;
+
+    GameObject* gameObject = nullptr;
+};
+
+struct GameObject : Object {
+    UnityW<Transform> get_transform() const;
+
+    template <typename T>
+    T* AddComponent() {
+        auto component = std::make_unique<T>();
+        component->gameObject = this;
+        BSMLMock::counters.components++;
+        return static_cast<T*>(components.emplace_back(std::move(component)).get());
+    }
+
+    template <typename T>
+    T GetComponent() const {
+        for (auto const& component : components) {
+            if (auto match = dynamic_cast<T>(component.get())) {
+                return match;
+            }
+        }
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<Component>> components;
+};
+
+template <typename T>
+T Component::GetComponent() const {
+    return gameObject->GetComponent<T>();
+}
+
+struct Transform : Component {
+    void SetParent(Transform* newParent, bool worldPositionStays) {
+        parent = newParent;
+    }
+
+    Transform* parent = nullptr;
+};
+
+inline UnityW<Transform> Component::get_transform() const {
+    return gameObject->get_transform();
+}
+
+inline UnityW<Transform> GameObject::get_transform() const {
+    return GetComponent<Transform*>();
+}
+
+struct RectTransform : Transform {
+    void set_sizeDelta(Vector2 value) {
+        sizeDelta = value;
+    }
+    void set_anchoredPosition(Vector2 value) {
+        anchoredPosition = value;
+    }
+
+    Vector2 sizeDelta;
+    Vector2 anchoredPosition;
+    Vector2 pivot;
+    Vector2 anchorMin;
+    Vector2 anchorMax;
+    Vector3 localScale;
+    Vector3 localEulerAngles;
+};
+
+struct Canvas : Component {
+    void set_overrideSorting(bool value) {
+        overrideSorting = value;
+    }
+
+    bool overrideSorting = false;
+};
+}  // namespace UnityEngine
+
+namespace UnityEngine::UI {
+struct LayoutElement : Component {
+    void set_minWidth(float value) {
+        minWidth = value;
+    }
+    void set_preferredWidth(float value) {
+        preferredWidth = value;
+    }
+    void set_preferredHeight(float value) {
+        preferredHeight = value;
+    }
+
+    float minWidth = -1;
+    float preferredWidth = -1;
+    float preferredHeight = -1;
+};
+
+struct ContentSizeFitter : Component {};
+struct CanvasScaler : Component {};
+struct GraphicRaycaster : Component {};
+
+struct LayoutGroup : Component {
+    RectTransform* get_rectTransform() const {
+        return GetComponent<RectTransform*>();
+    }
+    void set_padding(RectOffset* value) {
+        padding = value;
+    }
+    void set_childAlignment(TextAnchor value) {
+        childAlignment = value;
+    }
+
+    RectOffset* padding = nullptr;
+    TextAnchor childAlignment = TextAnchor::UpperLeft;
+};
+
+struct HorizontalOrVerticalLayoutGroup : LayoutGroup {
+    void set_spacing(float value) {
+        spacing = value;
+    }
+    void set_childForceExpandWidth(bool value) {
+        childForceExpandWidth = value;
+    }
+    void set_childForceExpandHeight(bool value) {
+        childForceExpandHeight = value;
+    }
+    void set_childControlWidth(bool value) {
+        childControlWidth = value;
+    }
+    void set_childControlHeight(bool value) {
+        childControlHeight = value;
+    }
+
+    float spacing = 0;
+    bool childForceExpandWidth = true;
+    bool childForceExpandHeight = true;
+    bool childControlWidth = true;
+    bool childControlHeight = true;
+};
+
+struct VerticalLayoutGroup : HorizontalOrVerticalLayoutGroup {};
+struct HorizontalLayoutGroup : HorizontalOrVerticalLayoutGroup {};
+}  // namespace UnityEngine::UI
+
+namespace TMPro {
+enum class TextAlignmentOptions {
+    TopLeft,
+    Top,
+    Left,
+    Center,
+    BottomLeft,
+    Bottom,
+};
+
+enum class TextOverflowModes {
+    Overflow,
+    Ellipsis,
+};
+
+struct TextMeshProUGUI : UnityEngine::Component {
+    UnityEngine::RectTransform* get_rectTransform() const {
+        return GetComponent<UnityEngine::RectTransform*>();
+    }
+    void set_text(std::string_view value) {
+        text = value;
+    }
+    void set_alignment(TextAlignmentOptions value) {
+        alignment = value;
+    }
+    void set_overflowMode(TextOverflowModes value) {
+        overflowMode = value;
+    }
+    void set_fontSize(float value) {
+        fontSize = value;
+    }
+
+    UnityEngine::CountedString text;
+    TextAlignmentOptions alignment = TextAlignmentOptions::TopLeft;
+    TextOverflowModes overflowMode = TextOverflowModes::Overflow;
+    float fontSize = 4;
+};
+}  // namespace TMPro
+
+namespace HMUI {
+struct ViewController : UnityEngine::Component {};
+
+struct ImageView : UnityEngine::Component {
+    UnityEngine::RectTransform* rectTransform = nullptr;
+    UnityEngine::Sprite* sprite = nullptr;
+};
+
+struct HoverHint : UnityEngine::Component {
+    void set_text(std::string_view value) {
+        text = value;
+    }
+
+    UnityEngine::CountedString text;
+};
+}  // namespace HMUI
+
+namespace BSMLMock {
+/// @brief Everything created through the mock, destroyed by Reset().
+inline std::vector<std::unique_ptr<UnityEngine::Object>> objects;
+
+template <typename T>
+T* Create() {
+    return static_cast<T*>(objects.emplace_back(std::make_unique<T>()).get());
+}
+
+/// @brief Creates a game object with a RectTransform, like every UI object in the game.
+inline UnityEngine::GameObject* CreateGameObject(std::string_view name, UnityEngine::Transform* parent) {
+    auto gameObject = Create<UnityEngine::GameObject>();
+    gameObject->name = name;
+    counters.objects++;
+    gameObject->AddComponent<UnityEngine::RectTransform>()->SetParent(parent, false);
+    return gameObject;
+}
+
+/// @brief Destroys everything created so far and zeroes the counters.
+inline void Reset() {
+    objects.clear();
+    counters = {};
+}
+}  // namespace BSMLMock
+
+inline UnityEngine::RectOffset* UnityEngine::RectOffset::New_ctor(int left, int right, int top, int bottom) {
+    auto offset = BSMLMock::Create<RectOffset>();
+    offset->left = left;
+    offset->right = right;
+    offset->top = top;
+    offset->bottom = bottom;
+    return offset;
+}
+
+namespace BSML::Lite {
+/// @brief Anything that has a transform, as accepted by the BSML::Lite creation functions.
+struct TransformWrapper {
+    TransformWrapper(UnityEngine::Transform* transform) : transform(transform) {}
+    TransformWrapper(UnityEngine::GameObject* gameObject) : transform(gameObject->get_transform()) {}
+    TransformWrapper(UnityEngine::Component* component) : transform(component->get_transform()) {}
+    template <typename T>
+    TransformWrapper(UnityW<T> const& object) : TransformWrapper(object.ptr) {}
+
+    operator UnityEngine::Transform*() const {
+        return transform;
+    }
+
+    UnityEngine::Transform* transform;
+};
+
+/// @brief Anything that has a game object, as accepted by the BSML::Lite creation functions.
+struct GameObjectWrapper {
+    GameObjectWrapper(UnityEngine::GameObject* gameObject) : gameObject(gameObject) {}
+    GameObjectWrapper(UnityEngine::Component* component) : gameObject(component->get_gameObject()) {}
+
+    operator UnityEngine::GameObject*() const {
+        return gameObject;
+    }
+
+    UnityEngine::GameObject* gameObject;
+};
+
+inline TMPro::TextMeshProUGUI* CreateText(TransformWrapper const& parent, std::string_view text) {
+    auto gameObject = BSMLMock::CreateGameObject("BSMLText", parent);
+    auto textMesh = gameObject->AddComponent<TMPro::TextMeshProUGUI>();
+    textMesh->set_text(text);
+    gameObject->AddComponent<UnityEngine::UI::LayoutElement>();
+    return textMesh;
+}
+
+inline UnityEngine::UI::VerticalLayoutGroup* CreateVerticalLayoutGroup(TransformWrapper const& parent) {
+    auto gameObject = BSMLMock::CreateGameObject("BSMLVerticalLayoutGroup", parent);
+    auto layout = gameObject->AddComponent<UnityEngine::UI::VerticalLayoutGroup>();
+    gameObject->AddComponent<UnityEngine::UI::ContentSizeFitter>();
+    gameObject->AddComponent<UnityEngine::UI::LayoutElement>();
+    return layout;
+}
+
+inline UnityEngine::UI::HorizontalLayoutGroup* CreateHorizontalLayoutGroup(TransformWrapper const& parent) {
+    auto gameObject = BSMLMock::CreateGameObject("BSMLHorizontalLayoutGroup", parent);
+    auto layout = gameObject->AddComponent<UnityEngine::UI::HorizontalLayoutGroup>();
+    gameObject->AddComponent<UnityEngine::UI::ContentSizeFitter>();
+    gameObject->AddComponent<UnityEngine::UI::LayoutElement>();
+    return layout;
+}
+
+inline HMUI::ImageView* CreateImage(
+    TransformWrapper const& parent, UnityEngine::Sprite* sprite, UnityEngine::Vector2 anchoredPosition = {}, UnityEngine::Vector2 sizeDelta = {}
+) {
+    auto gameObject = BSMLMock::CreateGameObject("BSMLImage", parent);
+    auto image = gameObject->AddComponent<HMUI::ImageView>();
+    image->sprite = sprite;
+    image->rectTransform = gameObject->GetComponent<UnityEngine::RectTransform*>();
+    image->rectTransform->anchoredPosition = anchoredPosition;
+    image->rectTransform->sizeDelta = sizeDelta;
+    return image;
+}
+
+inline HMUI::HoverHint* AddHoverHint(GameObjectWrapper const& gameObject, std::string_view text) {
+    auto hoverHint = gameObject.gameObject->AddComponent<HMUI::HoverHint>();
+    hoverHint->set_text(text);
+    return hoverHint;
+}
+
+inline UnityEngine::GameObject* CreateCanvas() {
+    auto gameObject = BSMLMock::CreateGameObject("BSMLCanvas", nullptr);
+    gameObject->AddComponent<UnityEngine::Canvas>();
+    gameObject->AddComponent<UnityEngine::UI::CanvasScaler>();
+    gameObject->AddComponent<UnityEngine::UI::GraphicRaycaster>();
+    return gameObject;
+}
+}  // namespace BSML::Lite
+
+namespace BSML::Utilities::ImageResources {
+inline UnityEngine::Sprite* GetWhitePixel() {
+    static UnityEngine::Sprite whitePixel;
+    return &whitePixel;
+}
+}  // namespace BSML::Utilities::ImageResources
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+#include "diagnostics.hpp"
+#include "elf_builder.hpp"
+#include "fmt/format.h"
+#include "library_usage.hpp"
+#include "scotland2/shared/modloader.h"
+#include "test_utils.hpp"
+
+// A deque, so the strings the stub points at never move
+static std::deque<std::string> strings;
+
+/// @brief Reports a library as loaded by the modloader stub, optionally writing it to the files dir.
+static void AddLoaded(std::string_view relativePath, std::string_view contents = {}) {
+    std::string const& path = strings.emplace_back(fmt::format("{}/{}", modloader_get_files_dir(), relativePath));
+    if (!contents.empty()) {
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+        WriteFile(path, contents);
+    }
+
+    CLoadResult result{};
+    result.result = MatchType_Loaded;
+    result.loaded.info = {strings.emplace_back(std::filesystem::path(path).stem().string()).c_str(), "1.0.0", 0};
+    result.loaded.path = path.c_str();
+    ModloaderStub::all.push_back(result);
+    ModloaderStub::loaded.push_back(result.loaded);
+}
+
+/// @brief Reports a library as failed to load by the modloader stub.
+static void AddFailed(std::string_view relativePath, std::string_view failure) {
+    CLoadResult result{};
+    result.result = LoadResult_Failed;
+    result.failed.path = strings.emplace_back(fmt::format("{}/{}", modloader_get_files_dir(), relativePath)).c_str();
+    result.failed.failure = strings.emplace_back(failure).c_str();
+    ModloaderStub::all.push_back(result);
+}
+
+static std::string GetBinaryDiagnosticsPath() {
+    return fmt::format("{}/{}_diagnostics.bin", modloader_get_files_dir(), MOD_ID);
+}
+
+TEST(DiagnosticsTest, UnusedIsUnknownUntilTheUsageAnalysisIsDone) {
+    ExpectInFreshProcess([] {
+        AddLoaded("libs/libunused.so", BuildElf({}));
+        AddLoaded("mods/libmod.so", BuildElf({}));
+
+        ASSERT_TRUE(ExportDiagnostics());
+        ASSERT_TRUE(WaitForDiagnosticsExport(std::chrono::seconds(10)));
+        std::string json = ReadFile(GetDiagnosticsPath());
+        EXPECT_NE(json.find("{\"name\": \"libunused.so\", \"failure\": null, \"integrityIssue\": null, \"unused\": null}"), std::string::npos)
+            << json;
+
+        StartLibraryUsageAnalysis();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!IsLibraryUsageAnalysisDone() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_TRUE(IsLibraryUsageAnalysisDone());
+
+        ASSERT_TRUE(ExportDiagnostics());
+        ASSERT_TRUE(WaitForDiagnosticsExport(std::chrono::seconds(10)));
+        json = ReadFile(GetDiagnosticsPath());
+        EXPECT_NE(json.find("{\"name\": \"libunused.so\", \"failure\": null, \"integrityIssue\": null, \"unused\": true}"), std::string::npos)
+            << json;
+    });
+}
+
+TEST(DiagnosticsTest, BinaryMarksUnusedAsUnknownUntilTheUsageAnalysisIsDone) {
+    ExpectInFreshProcess([] {
+        AddLoaded("libs/libunused.so");
+
+        ASSERT_TRUE(ExportDiagnostics());
+        ASSERT_TRUE(WaitForDiagnosticsExport(std::chrono::seconds(10)));
+        std::string binary = ReadFile(GetBinaryDiagnosticsPath());
+
+        ASSERT_GE(binary.size(), 8);
+        EXPECT_EQ(binary.substr(0, 4), "MLDG");
+        EXPECT_EQ(binary[4], 2);
+
+        // The libs section: section, count, name, no failure, no integrity issue, unused
+        std::string name = "libunused.so";
+        std::string section = std::string("\x01\x01\0\0\0", 5) + char(name.size()) + std::string(3, '\0') + name + std::string(8, '\xFF') + '\xFF';
+        EXPECT_NE(binary.find(section), std::string::npos);
+    });
+}
+
+TEST(DiagnosticsTest, SerializationThroughput) {
+    ExpectInFreshProcess([] {
+        // Far more than any real setup, so the time is dominated by serialization rather than the fixed fsync cost
+        for (int i = 0; i < 5000; i++) {
+            AddLoaded(fmt::format("mods/libsome-mod-{}.so", i));
+            AddLoaded(fmt::format("libs/libsome-library-{}.so", i));
+            AddFailed(
+                fmt::format("early_mods/libbroken-\"mod\"-{}.so", i),
+                fmt::format("dlopen failed: cannot locate symbol \"_ZN7missing{}Ev\" referenced by\n\t\"libbroken-mod-{}.so\"", i, i)
+            );
+        }
+
+        // Warm up, the first export also sets up the load info and the boot record
+        ASSERT_TRUE(ExportDiagnostics());
+        ASSERT_TRUE(WaitForDiagnosticsExport(std::chrono::seconds(30)));
+
+        double best = 1e9;
+        for (int run = 0; run < 5; run++) {
+            auto start = std::chrono::steady_clock::now();
+            ASSERT_TRUE(ExportDiagnostics());
+            ASSERT_TRUE(WaitForDiagnosticsExport(std::chrono::seconds(30)));
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        uint64_t bytes = std::filesystem::file_size(GetDiagnosticsPath()) + std::filesystem::file_size(GetBinaryDiagnosticsPath());
+        double megabytesPerSecond = bytes / best / 1e6;
+        std::printf("Diagnostics export: %.1f MB in %.1f ms, %.0f MB/s\n", bytes / 1e6, best * 1e3, megabytesPerSecond);
+    });
+}
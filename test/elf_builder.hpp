@@ -0,0 +1,134 @@
+#pragma once
+
+#include <elf.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// @brief What to put in a synthetic ELF library. Only the headers are real, there is no code to run.
+struct SyntheticElf {
+    std::vector<std::string> needed;
+    size_t relocationCount = 0;
+    size_t relativeRelocationCount = 0;
+    size_t undefinedSymbolCount = 0;
+    size_t initArrayCount = 0;
+    /// @brief Extra bytes in the loadable segment, to make the file a given size.
+    size_t payloadSize = 0;
+};
+
+/// @brief Offsets of the headers in a file built by BuildElf(), for tests that corrupt them.
+struct SyntheticElfLayout {
+    size_t programHeaders;
+    size_t dynamicSegment;
+    size_t sectionHeaders;
+};
+
+/**
+ * @brief Builds a 64-bit ELF shared library with a single loadable segment covering the whole file.
+ *
+ * The dynamic section holds the needed libraries and the relocation counts, .dynsym holds the undefined symbols.
+ */
+inline std::string BuildElf(SyntheticElf const& elf, SyntheticElfLayout* layout = nullptr) {
+    auto align = [](std::string& data) {
+        data.resize((data.size() + 7) & ~size_t(7));
+    };
+    auto append = [](std::string& data, auto const& value) {
+        data.append(reinterpret_cast<char const*>(&value), sizeof(value));
+    };
+
+    std::string file(sizeof(Elf64_Ehdr) + 2 * sizeof(Elf64_Phdr), '\0');
+
+    // .dynstr, the symbol names point at the first needed entry or an empty name
+    size_t stringTableOffset = file.size();
+    std::vector<size_t> neededOffsets;
+    file += '\0';
+    file += "sym";
+    file += '\0';
+    for (auto const& name : elf.needed) {
+        neededOffsets.push_back(file.size() - stringTableOffset);
+        file += name;
+        file += '\0';
+    }
+    size_t stringTableSize = file.size() - stringTableOffset;
+    align(file);
+
+    // .dynsym, the null symbol and then the undefined ones
+    size_t symbolTableOffset = file.size();
+    append(file, Elf64_Sym{});
+    for (size_t i = 0; i < elf.undefinedSymbolCount; i++) {
+        Elf64_Sym symbol{};
+        symbol.st_name = 1;
+        symbol.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+        symbol.st_shndx = SHN_UNDEF;
+        append(file, symbol);
+    }
+    size_t symbolTableSize = file.size() - symbolTableOffset;
+
+    // .dynamic, addresses equal file offsets since the segment is loaded at 0
+    size_t dynamicOffset = file.size();
+    for (size_t offset : neededOffsets) {
+        append(file, Elf64_Dyn{DT_NEEDED, {offset}});
+    }
+    append(file, Elf64_Dyn{DT_STRTAB, {stringTableOffset}});
+    append(file, Elf64_Dyn{DT_STRSZ, {stringTableSize}});
+    append(file, Elf64_Dyn{DT_SYMTAB, {symbolTableOffset}});
+    append(file, Elf64_Dyn{DT_RELASZ, {elf.relocationCount * sizeof(Elf64_Rela)}});
+    append(file, Elf64_Dyn{DT_RELAENT, {sizeof(Elf64_Rela)}});
+    append(file, Elf64_Dyn{DT_RELACOUNT, {elf.relativeRelocationCount}});
+    append(file, Elf64_Dyn{DT_INIT_ARRAYSZ, {elf.initArrayCount * sizeof(Elf64_Addr)}});
+    append(file, Elf64_Dyn{DT_NULL, {0}});
+    size_t dynamicSize = file.size() - dynamicOffset;
+
+    file.append(elf.payloadSize, '\x5A');
+    align(file);
+
+    // Section headers: the null section and .dynsym
+    size_t sectionHeadersOffset = file.size();
+    append(file, Elf64_Shdr{});
+    Elf64_Shdr symbolSection{};
+    symbolSection.sh_type = SHT_DYNSYM;
+    symbolSection.sh_offset = symbolTableOffset;
+    symbolSection.sh_addr = symbolTableOffset;
+    symbolSection.sh_size = symbolTableSize;
+    symbolSection.sh_entsize = sizeof(Elf64_Sym);
+    symbolSection.sh_addralign = 8;
+    append(file, symbolSection);
+
+    Elf64_Ehdr header{};
+    std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+    header.e_ident[EI_CLASS] = ELFCLASS64;
+    header.e_ident[EI_DATA] = ELFDATA2LSB;
+    header.e_ident[EI_VERSION] = EV_CURRENT;
+    header.e_type = ET_DYN;
+    header.e_machine = EM_AARCH64;
+    header.e_version = EV_CURRENT;
+    header.e_phoff = sizeof(Elf64_Ehdr);
+    header.e_shoff = sectionHeadersOffset;
+    header.e_ehsize = sizeof(Elf64_Ehdr);
+    header.e_phentsize = sizeof(Elf64_Phdr);
+    header.e_phnum = 2;
+    header.e_shentsize = sizeof(Elf64_Shdr);
+    header.e_shnum = 2;
+    std::memcpy(file.data(), &header, sizeof(header));
+
+    Elf64_Phdr segments[2]{};
+    segments[0].p_type = PT_LOAD;
+    segments[0].p_flags = PF_R;
+    segments[0].p_filesz = file.size();
+    segments[0].p_memsz = file.size();
+    segments[0].p_align = 4096;
+    segments[1].p_type = PT_DYNAMIC;
+    segments[1].p_flags = PF_R;
+    segments[1].p_offset = dynamicOffset;
+    segments[1].p_vaddr = dynamicOffset;
+    segments[1].p_filesz = dynamicSize;
+    segments[1].p_memsz = dynamicSize;
+    segments[1].p_align = 8;
+    std::memcpy(file.data() + sizeof(Elf64_Ehdr), segments, sizeof(segments));
+
+    if (layout) {
+        *layout = {sizeof(Elf64_Ehdr), dynamicOffset, sectionHeadersOffset};
+    }
+    return file;
+}
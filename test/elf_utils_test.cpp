@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+#include "elf_builder.hpp"
+#include "elf_utils.hpp"
+
+static std::span<uint8_t const> AsBytes(std::string const& data) {
+    return {reinterpret_cast<uint8_t const*>(data.data()), data.size()};
+}
+
+/// @brief Overwrites a field of a header in a built file.
+template <class Header, class Field>
+static void Patch(std::string& file, size_t headerOffset, Field Header::*field, Field value) {
+    Header header;
+    std::memcpy(&header, file.data() + headerOffset, sizeof(header));
+    header.*field = value;
+    std::memcpy(file.data() + headerOffset, &header, sizeof(header));
+}
+
+TEST(ElfUtilsTest, ReadsLibraryInfo) {
+    SyntheticElf elf{
+        .needed = {"libbeatsaber-hook.so", "libbsml.so"},
+        .relocationCount = 120,
+        .relativeRelocationCount = 100,
+        .undefinedSymbolCount = 7,
+        .initArrayCount = 3,
+        .payloadSize = 5000,
+    };
+    std::string file = BuildElf(elf);
+
+    EXPECT_EQ(CheckElfBounds(AsBytes(file)), std::nullopt);
+    auto info = ReadElfLibraryInfo(AsBytes(file));
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->needed, elf.needed);
+    EXPECT_EQ(info->relocationCount, 120);
+    EXPECT_EQ(info->relativeRelocationCount, 100);
+    EXPECT_EQ(info->undefinedSymbolCount, 7);
+    EXPECT_EQ(info->initArrayCount, 3);
+    EXPECT_EQ(info->mappedSize % 4096, 0);
+    EXPECT_GE(info->mappedSize, file.size());
+}
+
+TEST(ElfUtilsTest, TruncatedFilesAreReported) {
+    std::string file = BuildElf({.payloadSize = 5000});
+
+    for (size_t size : {size_t(0), size_t(3), sizeof(Elf64_Ehdr) - 1, sizeof(Elf64_Ehdr) + 10, file.size() - 1}) {
+        std::string truncated = file.substr(0, size);
+        EXPECT_NE(CheckElfBounds(AsBytes(truncated)), std::nullopt) << size;
+        EXPECT_EQ(ReadElfLibraryInfo(AsBytes(truncated)), std::nullopt) << size;
+    }
+}
+
+// Offsets near 2^64 wrap around when added to a size, the checks must not be fooled by that
+static constexpr uint64_t wrappingOffset = 0xFFFFFFFFFFFFFF00ull;
+
+TEST(ElfUtilsTest, WrappingProgramHeaderOffsetIsReported) {
+    std::string file = BuildElf({});
+    Patch(file, 0, &Elf64_Ehdr::e_phoff, wrappingOffset);
+
+    EXPECT_NE(CheckElfBounds(AsBytes(file)), std::nullopt);
+    EXPECT_EQ(ReadElfLibraryInfo(AsBytes(file)), std::nullopt);
+}
+
+TEST(ElfUtilsTest, WrappingSectionRangeIsReported) {
+    SyntheticElfLayout layout;
+    std::string file = BuildElf({.undefinedSymbolCount = 4}, &layout);
+    size_t symbolSection = layout.sectionHeaders + sizeof(Elf64_Shdr);
+    Patch(file, symbolSection, &Elf64_Shdr::sh_offset, wrappingOffset);
+    Patch(file, symbolSection, &Elf64_Shdr::sh_size, Elf64_Xword(0x200));
+
+    EXPECT_NE(CheckElfBounds(AsBytes(file)), std::nullopt);
+    EXPECT_EQ(ReadElfLibraryInfo(AsBytes(file)), std::nullopt);
+}
+
+TEST(ElfUtilsTest, WrappingLoadSegmentIsReported) {
+    SyntheticElfLayout layout;
+    std::string file = BuildElf({}, &layout);
+    Patch(file, layout.programHeaders, &Elf64_Phdr::p_offset, wrappingOffset);
+    Patch(file, layout.programHeaders, &Elf64_Phdr::p_filesz, Elf64_Xword(0x200));
+
+    EXPECT_NE(CheckElfBounds(AsBytes(file)), std::nullopt);
+}
+
+TEST(ElfUtilsTest, WrappingDynamicSegmentIsSkipped) {
+    SyntheticElfLayout layout;
+    std::string file = BuildElf({.needed = {"libfoo.so"}, .relocationCount = 5}, &layout);
+    size_t dynamicHeader = layout.programHeaders + sizeof(Elf64_Phdr);
+    Patch(file, dynamicHeader, &Elf64_Phdr::p_offset, wrappingOffset);
+    Patch(file, dynamicHeader, &Elf64_Phdr::p_filesz, Elf64_Xword(0x200));
+
+    // The dynamic segment is not loadable, so the file is still complete, but the dynamic section is not read
+    auto info = ReadElfLibraryInfo(AsBytes(file));
+    ASSERT_TRUE(info.has_value());
+    EXPECT_TRUE(info->needed.empty());
+    EXPECT_EQ(info->relocationCount, 0);
+}
+
+TEST(ElfUtilsTest, WrappingStringTableIsSkipped) {
+    SyntheticElfLayout layout;
+    std::string file = BuildElf({.needed = {"libfoo.so"}, .relocationCount = 5}, &layout);
+
+    // The DT_STRSZ entry follows DT_NEEDED and DT_STRTAB
+    size_t stringTableSizeEntry = layout.dynamicSegment + 2 * sizeof(Elf64_Dyn);
+    Elf64_Dyn entry;
+    std::memcpy(&entry, file.data() + stringTableSizeEntry, sizeof(entry));
+    ASSERT_EQ(entry.d_tag, DT_STRSZ);
+    entry.d_un.d_val = wrappingOffset;
+    std::memcpy(file.data() + stringTableSizeEntry, &entry, sizeof(entry));
+
+    auto info = ReadElfLibraryInfo(AsBytes(file));
+    ASSERT_TRUE(info.has_value());
+    EXPECT_TRUE(info->needed.empty());
+    EXPECT_EQ(info->relocationCount, 5);
+}
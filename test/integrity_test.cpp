@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "elf_builder.hpp"
+#include "fmt/format.h"
+#include "integrity.hpp"
+#include "scotland2/shared/modloader.h"
+#include "test_utils.hpp"
+
+static std::string GetFilesPath(std::string_view relativePath) {
+    return fmt::format("{}/{}", modloader_get_files_dir(), relativePath);
+}
+
+static std::string GetKnownGoodPath() {
+    return GetFilesPath(fmt::format("{}_known_good.txt", MOD_ID));
+}
+
+/// @brief Writes a file in the files dir, reported as loaded by the modloader stub.
+static void WriteLoadedFile(std::string_view relativePath, std::string_view contents) {
+    static std::vector<std::string> paths;
+
+    std::string path = GetFilesPath(relativePath);
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    WriteFile(path, contents);
+
+    CLoadResult result{};
+    result.result = MatchType_Loaded;
+    result.loaded.path = paths.emplace_back(path).c_str();
+    ModloaderStub::all.push_back(result);
+}
+
+static std::string GetKnownGoodRecord(std::string_view relativePath, uint64_t hash) {
+    struct stat st;
+    stat(GetFilesPath(relativePath).c_str(), &st);
+    return fmt::format("{}\t{}\t{}\t{:x}\n", relativePath, st.st_size, st.st_mtime, hash);
+}
+
+static uint64_t Hash(std::string_view data) {
+    return HashContents({reinterpret_cast<uint8_t const*>(data.data()), data.size()});
+}
+
+TEST(IntegrityTest, HashMatchesXXH64) {
+    EXPECT_EQ(Hash(""), 0xEF46DB3751D8E999ull);
+    EXPECT_EQ(Hash("hello world!x"), 0x13F5F4CF246438BAull);
+
+    std::string repeated;
+    for (int i = 0; i < 40; i++) {
+        repeated += "abc";
+    }
+    EXPECT_EQ(Hash(repeated), 0xF12B198FF8DB99E5ull);
+}
+
+TEST(IntegrityTest, HashThroughput) {
+    std::vector<uint8_t> data(256 << 20);
+    std::mt19937_64 random(42);
+    for (size_t i = 0; i + 8 <= data.size(); i += 8) {
+        uint64_t value = random();
+        std::memcpy(&data[i], &value, sizeof(value));
+    }
+
+    // Best of a few runs, the first one also pays for faulting in the pages
+    double best = 1e9;
+    uint64_t hash = 0;
+    for (int run = 0; run < 5; run++) {
+        auto start = std::chrono::steady_clock::now();
+        hash ^= HashContents(data);
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    double gigabytesPerSecond = data.size() / best / 1e9;
+    std::printf("HashContents: %.2f GB/s (hash %016llx)\n", gigabytesPerSecond, static_cast<unsigned long long>(hash));
+    RecordProperty("gigabytesPerSecond", fmt::format("{:.2f}", gigabytesPerSecond));
+}
+
+TEST(IntegrityTest, ScanThroughput) {
+    ExpectInFreshProcess([] {
+        // 96 libraries of 1 to 4 MiB, about the size of a large mod setup
+        std::mt19937 random(7);
+        uint64_t totalBytes = 0;
+        for (int i = 0; i < 96; i++) {
+            SyntheticElf elf;
+            elf.payloadSize = (1 << 20) + random() % (3 << 20);
+            std::string contents = BuildElf(elf);
+            totalBytes += contents.size();
+            WriteLoadedFile(fmt::format("{}/lib{}.so", i % 3 == 0 ? "libs" : i % 3 == 1 ? "mods" : "early_mods", i), contents);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        StartIntegrityScan();
+        ASSERT_TRUE(WaitForIntegrityScan(std::chrono::seconds(60)));
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double gigabytesPerSecond = totalBytes / elapsed / 1e9;
+        std::printf("Integrity scan: %.1f MB in %.0f ms, %.2f GB/s\n", totalBytes / 1e6, elapsed * 1e3, gigabytesPerSecond);
+
+        for (int i = 0; i < 96; i++) {
+            EXPECT_EQ(GetIntegrityIssue(i % 3 == 0 ? "libs" : i % 3 == 1 ? "mods" : "early_mods", fmt::format("lib{}.so", i)), nullptr);
+        }
+    });
+}
+
+TEST(IntegrityTest, NotReadyBeforeTheScanStarts) {
+    EXPECT_FALSE(WaitForIntegrityScan(std::chrono::milliseconds(0)));
+    EXPECT_EQ(GetIntegrityIssue("mods", "libfoo.so"), nullptr);
+}
+
+TEST(IntegrityTest, TruncatedLibrariesAreReported) {
+    ExpectInFreshProcess([] {
+        std::string contents = BuildElf({.payloadSize = 10000});
+        WriteLoadedFile("mods/libtruncated.so", std::string_view(contents).substr(0, contents.size() - 100));
+        WriteLoadedFile("mods/libcomplete.so", contents);
+
+        StartIntegrityScan();
+        ASSERT_TRUE(WaitForIntegrityScan(std::chrono::seconds(10)));
+
+        auto issue = GetIntegrityIssue("mods", "libtruncated.so");
+        ASSERT_NE(issue, nullptr);
+        EXPECT_TRUE(issue->starts_with("File is truncated")) << *issue;
+        EXPECT_EQ(GetIntegrityIssue("mods", "libcomplete.so"), nullptr);
+    });
+}
+
+TEST(IntegrityTest, ChangedContentsWithTheSameSizeAndTimeAreReported) {
+    ExpectInFreshProcess([] {
+        std::string contents = BuildElf({.payloadSize = 10000});
+        WriteLoadedFile("mods/libcorrupted.so", contents);
+        WriteFile(GetKnownGoodPath(), GetKnownGoodRecord("mods/libcorrupted.so", Hash(contents) + 1));
+
+        StartIntegrityScan();
+        ASSERT_TRUE(WaitForIntegrityScan(std::chrono::seconds(10)));
+
+        auto issue = GetIntegrityIssue("mods", "libcorrupted.so");
+        ASSERT_NE(issue, nullptr);
+        EXPECT_TRUE(issue->starts_with("File contents changed")) << *issue;
+    });
+}
+
+TEST(IntegrityTest, RecordsOfDeletedFilesArePruned) {
+    ExpectInFreshProcess([] {
+        std::string contents = BuildElf({.payloadSize = 1000});
+        WriteLoadedFile("mods/libkept.so", contents);
+        WriteFile(GetKnownGoodPath(), std::string("mods/libdeleted.so\t1000\t1700000000\tabcdef\n") + GetKnownGoodRecord("mods/libkept.so", Hash(contents)));
+
+        StartIntegrityScan();
+        ASSERT_TRUE(WaitForIntegrityScan(std::chrono::seconds(10)));
+
+        EXPECT_EQ(ReadFile(GetKnownGoodPath()), GetKnownGoodRecord("mods/libkept.so", Hash(contents)));
+    });
+}
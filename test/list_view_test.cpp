@@ -0,0 +1,325 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "boot_history.hpp"
+#include "bsml_mock.hpp"
+#include "elf_builder.hpp"
+#include "fmt/format.h"
+#include "integrity.hpp"
+#include "library_usage.hpp"
+#include "list_items.hpp"
+#include "list_view.hpp"
+#include "scotland2/shared/modloader.h"
+#include "startup_cost.hpp"
+#include "test_utils.hpp"
+
+// What each row of a list may cost. A row is one text object, with its RectTransform, TextMeshProUGUI, LayoutElement and
+// HoverHint. The strings are the row text, the hover hint and the object name.
+static constexpr size_t objectsPerMod = 1;
+static constexpr size_t componentsPerMod = 4;
+static constexpr size_t bytesPerMod = 256;
+
+// What a list may cost on top of its rows: the layouts, the title and, for the failed list, the separators.
+static constexpr size_t objectsPerList = 4;
+static constexpr size_t componentsPerList = 16;
+static constexpr size_t bytesPerList = 256;
+
+// The mod list has five columns, the fail dialog two lists
+static constexpr size_t modListColumns = 5;
+static constexpr size_t failDialogLists = 2;
+
+/// @brief Reports a library as loaded or failed by the modloader stub, and writes it to the files dir unless empty.
+static void AddLibrary(std::string_view relativePath, std::string_view id, std::string_view contents, std::optional<std::string_view> failure) {
+    // A deque, so the strings the stub points at never move
+    static std::deque<std::string> strings;
+
+    std::string const& path = strings.emplace_back(fmt::format("{}/{}", modloader_get_files_dir(), relativePath));
+    if (!contents.empty()) {
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+        WriteFile(path, contents);
+    }
+
+    CLoadResult result{};
+    if (failure) {
+        result.result = LoadResult_Failed;
+        result.failed = {path.c_str(), strings.emplace_back(*failure).c_str()};
+    } else {
+        result.result = MatchType_Loaded;
+        result.loaded.info = {strings.emplace_back(id).c_str(), "1.2.3", 0};
+        result.loaded.path = path.c_str();
+        ModloaderStub::loaded.push_back(result.loaded);
+    }
+    ModloaderStub::all.push_back(result);
+}
+
+/**
+ * @brief Sets up a game with the given number of mods, each adding one row to the mod list.
+ *
+ * Most mods load and log a few errors and warnings, some are early mods, some failed to load (one in three of those
+ * because the file is truncated) and some are libraries, half of which nothing needs. The last boot loaded everything,
+ * so every failure is new. This gives every row the longest text it can have.
+ */
+static void AddSyntheticMods(size_t count) {
+    std::string log;
+    for (size_t i = 0; i < count; i++) {
+        std::string id = fmt::format("some-mod-{}", i);
+        std::string library = fmt::format("libsome-library-{}.so", i / 10 * 10 + 9);
+        std::string failure =
+            fmt::format("dlopen failed: cannot locate symbol \"_ZN7missing{}Ev\" referenced by \"libbroken-mod-{}.so\"", i, i);
+        std::string truncated = BuildElf({.relocationCount = 100}).substr(0, 100);
+
+        switch (i % 10) {
+            case 7:
+                AddLibrary(fmt::format("mods/libbroken-mod-{}.so", i), "", i % 3 == 0 ? truncated : "", failure);
+                break;
+            case 8:
+                AddLibrary(fmt::format("early_mods/libbroken-mod-{}.so", i), "", "", failure);
+                break;
+            case 9:
+                AddLibrary(fmt::format("libs/libsome-library-{}.so", i), "", BuildElf({.relocationCount = 500}), std::nullopt);
+                break;
+            default: {
+                bool early = i % 10 == 6;
+                SyntheticElf elf{.relocationCount = 1000 + i, .undefinedSymbolCount = 100, .initArrayCount = 4};
+                if (i % 20 < 10) {
+                    elf.needed.push_back(library);
+                }
+                AddLibrary(fmt::format("{}/lib{}.so", early ? "early_mods" : "mods", id), id, BuildElf(elf), std::nullopt);
+                for (int line = 0; line < 4; line++) {
+                    log += fmt::format("[2026-10-18 19:12:28.123] {} [{}_1.2.3] [main] something went wrong {}\n", line ? 'E' : 'W', id, line);
+                }
+            }
+        }
+    }
+
+    std::filesystem::create_directories(fmt::format("{}/../logs2", modloader_get_files_dir()));
+    WriteFile(fmt::format("{}/../logs2/PaperLog.log", modloader_get_files_dir()), log);
+
+    // A boot history with one good boot, in the format RecordCurrentBoot() writes
+    struct {
+        uint32_t magic = 0x544F4F42;
+        uint16_t version = 1;
+        uint16_t recordSize = sizeof(BootRecord);
+        uint32_t capacity = 64;
+        uint32_t reserved = 0;
+    } header;
+    BootRecord goodBoot{.sequence = 1, .loadTimeMs = 12000, .timestamp = 1700000000, .loadedMods = uint16_t(count)};
+    std::string history(reinterpret_cast<char const*>(&header), sizeof(header));
+    history.append(reinterpret_cast<char const*>(&goodBoot), sizeof(goodBoot));
+    WriteFile(fmt::format("{}/{}_boot_history.bin", modloader_get_files_dir(), MOD_ID), history);
+}
+
+/// @brief Runs the background analyses the view starts at boot, and waits for them.
+static void RunAnalyses() {
+    StartIntegrityScan();
+    StartLibraryUsageAnalysis();
+    StartStartupCostEstimate();
+    ASSERT_TRUE(WaitForIntegrityScan(std::chrono::seconds(30)));
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    std::string lastMod = fmt::format("{}/mods/libsome-mod-0.so", modloader_get_files_dir());
+    while ((!IsLibraryUsageAnalysisDone() || !GetStartupCost(lastMod)) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(IsLibraryUsageAnalysisDone());
+    ASSERT_TRUE(GetStartupCost(lastMod).has_value());
+}
+
+/// @brief Counts the rows of the lists built since the mock was reset.
+static size_t CountRows() {
+    size_t rows = 0;
+    for (auto const& object : BSMLMock::objects) {
+        auto gameObject = dynamic_cast<UnityEngine::GameObject*>(object.get());
+        auto text = gameObject ? gameObject->GetComponent<TMPro::TextMeshProUGUI*>() : nullptr;
+        rows += text && text->name.value == "ModText";
+    }
+    return rows;
+}
+
+/// @brief Checks that what was created since the mock was reset fits the budget for the given number of mods and lists.
+static void ExpectWithinBudget(size_t modCount, size_t listCount) {
+    auto const& counters = BSMLMock::counters;
+    EXPECT_LE(counters.objects, objectsPerList * listCount + objectsPerMod * modCount);
+    EXPECT_LE(counters.components, componentsPerList * listCount + componentsPerMod * modCount);
+    EXPECT_LE(counters.stringBytes, bytesPerList * listCount + bytesPerMod * modCount);
+
+    std::printf(
+        "%zu mods: %.2f objects, %.2f components and %.1f string bytes per mod\n",
+        modCount,
+        double(counters.objects) / modCount,
+        double(counters.components) / modCount,
+        double(counters.stringBytes) / modCount
+    );
+}
+
+class ListViewBudgetTest : public testing::TestWithParam<size_t> {};
+
+TEST_P(ListViewBudgetTest, CreateModLists) {
+    ExpectInFreshProcess([modCount = GetParam()] {
+        AddSyntheticMods(modCount);
+        RunAnalyses();
+
+        BSMLMock::Reset();
+        auto root = BSMLMock::CreateGameObject("Root", nullptr)->get_transform();
+        auto titleRoot = BSMLMock::CreateGameObject("TitleRoot", nullptr)->get_transform();
+        BSMLMock::counters = {};
+
+        CreateModLists(root, titleRoot, true);
+
+        // Every mod has its row, with the text the real item builders give it
+        EXPECT_EQ(CountRows(), modCount);
+        size_t costs = 0, newFailures = 0, damagedFailures = 0, expectedDamaged = 0;
+        for (auto const& object : BSMLMock::objects) {
+            auto gameObject = dynamic_cast<UnityEngine::GameObject*>(object.get());
+            auto hoverHint = gameObject ? gameObject->GetComponent<HMUI::HoverHint*>() : nullptr;
+            auto text = gameObject ? gameObject->GetComponent<TMPro::TextMeshProUGUI*>() : nullptr;
+            if (!hoverHint || !text || text->name.value != "ModText") {
+                continue;
+            }
+            costs += hoverHint->text.value.starts_with("Estimated startup cost: ");
+            if (text->text.value.ends_with("(new)")) {
+                newFailures++;
+                damagedFailures += !hoverHint->text.value.starts_with("Failing since");
+            }
+        }
+        for (size_t i = 7; i < modCount; i += 10) {
+            expectedDamaged += i % 3 == 0;
+        }
+        EXPECT_EQ(costs, modCount * 7 / 10);
+        EXPECT_EQ(newFailures, modCount / 5);
+        EXPECT_EQ(damagedFailures, expectedDamaged);
+        ExpectWithinBudget(modCount, modListColumns);
+        BSMLMock::Reset();
+    });
+}
+
+TEST_P(ListViewBudgetTest, DrawFailedList) {
+    ExpectInFreshProcess([modCount = GetParam()] {
+        AddSyntheticMods(modCount);
+        RunAnalyses();
+
+        // Like the fail dialog, which only lists the failures
+        auto failedMods = GetFailureReasons(GetModsLoadInfo(), "mods");
+        auto failedEarlyMods = GetFailureReasons(GetEarlyModsLoadInfo(), "early_mods");
+        ASSERT_EQ(failedMods.size() + failedEarlyMods.size(), modCount / 5);
+
+        BSMLMock::Reset();
+        auto layout = BSML::Lite::CreateVerticalLayoutGroup(BSMLMock::CreateGameObject("Root", nullptr));
+        BSMLMock::counters = {};
+
+        drawFailedList(layout, failedMods, fmt::format("{} mods failed to load!", failedMods.size()));
+        drawFailedList(layout, failedEarlyMods, fmt::format("{} early mods failed to load!", failedEarlyMods.size()));
+
+        ExpectWithinBudget(failedMods.size() + failedEarlyMods.size(), failDialogLists);
+        BSMLMock::Reset();
+    });
+}
+
+INSTANTIATE_TEST_SUITE_P(ModCounts, ListViewBudgetTest, testing::Values(10, 100, 1000));
+
+TEST(ListViewTest, CreateListWithTitleAddsOneRowPerItem) {
+    BSMLMock::Reset();
+    auto root = BSMLMock::CreateGameObject("Root", nullptr)->get_transform();
+    auto titleRoot = BSMLMock::CreateGameObject("TitleRoot", nullptr)->get_transform();
+
+    std::vector<ListItem> items = {{"<color=green>a", ""}, {"<color=green>b", "hint"}, {"<color=red>c", "reason"}};
+    CreateListWithTitle(root, titleRoot, 31.5, "Libraries", items);
+
+    size_t rows = 0;
+    size_t hoverHints = 0;
+    for (auto const& object : BSMLMock::objects) {
+        auto gameObject = dynamic_cast<UnityEngine::GameObject*>(object.get());
+        auto text = gameObject ? gameObject->GetComponent<TMPro::TextMeshProUGUI*>() : nullptr;
+        if (text && text->name.value == "ModText") {
+            rows++;
+            hoverHints += gameObject->GetComponent<HMUI::HoverHint*>() != nullptr;
+        }
+    }
+    EXPECT_EQ(rows, items.size());
+    EXPECT_EQ(hoverHints, 2);
+
+    BSMLMock::Reset();
+}
+
+TEST(ListViewTest, DrawFailedListSkipsEmptyLists) {
+    BSMLMock::Reset();
+    auto layout = BSML::Lite::CreateVerticalLayoutGroup(BSMLMock::CreateGameObject("Root", nullptr));
+    auto before = BSMLMock::counters;
+
+    drawFailedList(layout, {}, "0 mods failed to load!");
+
+    EXPECT_EQ(BSMLMock::counters.objects, before.objects);
+    EXPECT_EQ(BSMLMock::counters.components, before.components);
+    BSMLMock::Reset();
+}
+
+TEST(ListViewTest, LazyHoverHintsAreBuiltOnceWhenShown) {
+    BSMLMock::Reset();
+    auto root = BSMLMock::CreateGameObject("Root", nullptr)->get_transform();
+    auto titleRoot = BSMLMock::CreateGameObject("TitleRoot", nullptr)->get_transform();
+
+    int calls = 0;
+    std::vector<ListItem> items = {{"<color=green>a", "1 errors and 0 warnings logged this session", [&calls]() {
+                                        calls++;
+                                        return std::string("E [a] something broke");
+                                    }}};
+    CreateListWithTitle(root, titleRoot, 31.5, "Loaded Mods", items);
+    EXPECT_EQ(calls, 0);
+
+    HMUI::HoverHint* hoverHint = nullptr;
+    for (auto const& object : BSMLMock::objects) {
+        if (auto gameObject = dynamic_cast<UnityEngine::GameObject*>(object.get()); gameObject && !hoverHint) {
+            hoverHint = gameObject->GetComponent<HMUI::HoverHint*>();
+        }
+    }
+    ASSERT_NE(hoverHint, nullptr);
+    EXPECT_EQ(hoverHint->text.value, "1 errors and 0 warnings logged this session");
+
+    ResolveLazyHoverHint(hoverHint);
+    ResolveLazyHoverHint(hoverHint);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(hoverHint->text.value, "1 errors and 0 warnings logged this session\nE [a] something broke");
+
+    ClearLazyHoverHints();
+    BSMLMock::Reset();
+}
+
+TEST(ListViewTest, FailedRowsGetTheIntegrityIssueWhenTheScanIsDone) {
+    ExpectInFreshProcess([] {
+        AddLibrary("mods/libbroken.so", "", BuildElf({.relocationCount = 100}).substr(0, 100), "dlopen failed: truncated");
+
+        // The dialog is built before the scan runs, without waiting for it
+        BSMLMock::Reset();
+        auto layout = BSML::Lite::CreateVerticalLayoutGroup(BSMLMock::CreateGameObject("Root", nullptr));
+        drawFailedList(layout, GetFailureReasons(GetModsLoadInfo(), "mods"), "1 mods failed to load!", "mods");
+
+        HMUI::HoverHint* hoverHint = nullptr;
+        for (auto const& object : BSMLMock::objects) {
+            if (auto gameObject = dynamic_cast<UnityEngine::GameObject*>(object.get()); gameObject && !hoverHint) {
+                hoverHint = gameObject->GetComponent<HMUI::HoverHint*>();
+            }
+        }
+        ASSERT_NE(hoverHint, nullptr);
+        ResolveLazyHoverHint(hoverHint);
+        EXPECT_EQ(hoverHint->text.value, "dlopen failed: truncated");
+
+        StartIntegrityScan();
+        ASSERT_TRUE(WaitForIntegrityScan(std::chrono::seconds(30)));
+        ResolveLazyHoverHint(hoverHint);
+        auto issue = GetIntegrityIssue("mods", "libbroken.so");
+        ASSERT_NE(issue, nullptr);
+        EXPECT_EQ(hoverHint->text.value, "dlopen failed: truncated\n" + *issue);
+
+        ClearLazyHoverHints();
+        BSMLMock::Reset();
+    });
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "fmt/format.h"
+#include "log_index.hpp"
+#include "scotland2/shared/modloader.h"
+#include "test_utils.hpp"
+
+static std::string GetLogPath() {
+    return fmt::format("{}/../logs2/PaperLog.log", modloader_get_files_dir());
+}
+
+/// @brief Appends lines to the log, without adding newlines.
+static void AppendLog(std::string_view text) {
+    std::filesystem::create_directories(std::filesystem::path(GetLogPath()).parent_path());
+    std::ofstream file(GetLogPath(), std::ios::binary | std::ios::app);
+    file.write(text.data(), text.size());
+}
+
+static std::string LogLine(char level, std::string_view tag, std::string_view message) {
+    return fmt::format("[2026-10-18 19:12:28.123] {} [{}] [main] {}\n", level, tag, message);
+}
+
+TEST(LogIndexTest, TagsMatchTheModIdOrTheIdWithAVersion) {
+    ExpectInFreshProcess([] {
+        AppendLog(LogLine('E', "mod-list", "counted"));
+        AppendLog(LogLine('W', "mod-list_1.2.0", "counted"));
+        AppendLog(LogLine('E', "mod-list_0", "counted"));
+        AppendLog(LogLine('E', "mod-list-extra", "another mod"));
+        AppendLog(LogLine('E', "mod-list_extra", "another mod"));
+        AppendLog(LogLine('E', "mod-listener", "another mod"));
+        AppendLog(LogLine('E', "mod-list:thread", "another mod"));
+        AppendLog(LogLine('E', "mod-list_", "another mod"));
+        AppendLog(LogLine('I', "mod-list", "not a warning or error"));
+        UpdateLogIndex();
+
+        auto summary = GetModLogSummary("mod-list");
+        ASSERT_TRUE(summary.has_value());
+        EXPECT_EQ(summary->errors, 2);
+        EXPECT_EQ(summary->warnings, 1);
+
+        auto other = GetModLogSummary("mod-list-extra");
+        ASSERT_TRUE(other.has_value());
+        EXPECT_EQ(other->errors, 1);
+        EXPECT_EQ(GetModLogSummary("mod"), std::nullopt);
+        EXPECT_EQ(GetModLogSummary(""), std::nullopt);
+    });
+}
+
+TEST(LogIndexTest, RecentErrorsAreOnlyReadOnDemand) {
+    ExpectInFreshProcess([] {
+        for (int i = 0; i < 5; i++) {
+            AppendLog(LogLine('E', "some-mod", fmt::format("error {}", i)));
+        }
+        UpdateLogIndex();
+
+        // The last three, without their newlines
+        std::string expected = LogLine('E', "some-mod", "error 2") + LogLine('E', "some-mod", "error 3") + LogLine('E', "some-mod", "error 4");
+        expected.pop_back();
+        EXPECT_EQ(GetRecentModErrors("some-mod"), expected);
+
+        // The counts come from the index alone, the error lines need the log
+        std::filesystem::remove(GetLogPath());
+        auto summary = GetModLogSummary("some-mod");
+        ASSERT_TRUE(summary.has_value());
+        EXPECT_EQ(summary->errors, 5);
+        EXPECT_EQ(GetRecentModErrors("some-mod"), "");
+    });
+}
+
+TEST(LogIndexTest, OnlyCompleteNewLinesAreIndexed) {
+    ExpectInFreshProcess([] {
+        AppendLog(LogLine('E', "some-mod", "first"));
+        AppendLog("[2026-10-18 19:12:28.123] E [some-m");
+        UpdateLogIndex();
+        EXPECT_EQ(GetModLogSummary("some-mod")->errors, 1);
+
+        AppendLog("od] [main] second\n");
+        UpdateLogIndex();
+        EXPECT_EQ(GetModLogSummary("some-mod")->errors, 2);
+
+        // A truncated log starts the index over
+        WriteFile(GetLogPath(), LogLine('W', "some-mod", "after truncation"));
+        UpdateLogIndex();
+        auto summary = GetModLogSummary("some-mod");
+        ASSERT_TRUE(summary.has_value());
+        EXPECT_EQ(summary->errors, 0);
+        EXPECT_EQ(summary->warnings, 1);
+    });
+}
+
+TEST(LogIndexTest, UpdatesOnlyReadNewBytes) {
+    ExpectInFreshProcess([] {
+        std::string first = LogLine('E', "some-mod", "first");
+        AppendLog(first);
+        UpdateLogIndex();
+
+        // Turn the indexed error into a warning without changing the size, an update must not read it again
+        std::string log = ReadFile(GetLogPath());
+        log[first.find(" E [") + 1] = 'W';
+        WriteFile(GetLogPath(), log);
+        AppendLog(LogLine('W', "some-mod", "second"));
+        UpdateLogIndex();
+
+        auto summary = GetModLogSummary("some-mod");
+        ASSERT_TRUE(summary.has_value());
+        EXPECT_EQ(summary->errors, 1);
+        EXPECT_EQ(summary->warnings, 1);
+
+        // Nothing new, nothing changes
+        UpdateLogIndex();
+        EXPECT_EQ(GetModLogSummary("some-mod")->errors, 1);
+        EXPECT_EQ(GetModLogSummary("some-mod")->warnings, 1);
+    });
+}
+
+// A benchmark, the numbers are reported rather than checked since they depend on the machine and its load
+TEST(LogIndexTest, IndexThroughput) {
+    ExpectInFreshProcess([] {
+        // About 47 MB and 400k lines, the log of a long session with 200 mods, a tenth of the lines warnings or errors
+        std::mt19937 random(3);
+        std::string log;
+        for (int i = 0; i < 400000; i++) {
+            uint32_t value = random();
+            char level = value % 20 == 0 ? 'E' : value % 20 == 1 ? 'W' : value % 2 ? 'I' : 'D';
+            log += LogLine(level, fmt::format("mod-{}_1.{}.0", value % 200, value % 7), fmt::format("message {} with some payload to make the line a typical length", i));
+        }
+        AppendLog(log);
+
+        auto start = std::chrono::steady_clock::now();
+        UpdateLogIndex();
+        double indexSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        uint32_t errors = 0;
+        for (int i = 0; i < 200; i++) {
+            if (auto summary = GetModLogSummary(fmt::format("mod-{}", i))) {
+                errors += summary->errors;
+            }
+        }
+        double lookupSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Reopening the menu only indexes what was added since
+        AppendLog(LogLine('E', "mod-0_1.0.0", "one more"));
+        start = std::chrono::steady_clock::now();
+        UpdateLogIndex();
+        double updateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double gigabytesPerSecond = log.size() / indexSeconds / 1e9;
+        std::printf(
+            "Log index: %.1f MB in %.1f ms (%.2f GB/s), 200 lookups in %.2f ms, update in %.3f ms\n",
+            log.size() / 1e6,
+            indexSeconds * 1e3,
+            gigabytesPerSecond,
+            lookupSeconds * 1e3,
+            updateSeconds * 1e3
+        );
+        EXPECT_GT(errors, 0);
+    });
+}
@@ -0,0 +1,190 @@
+#include <gtest/gtest.h>
+#include <zlib.h>
+
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "png_decoder.hpp"
+#include "test_utils.hpp"
+
+static void AppendBigEndian32(std::vector<uint8_t>& out, uint32_t value) {
+    out.insert(out.end(), {uint8_t(value >> 24), uint8_t(value >> 16), uint8_t(value >> 8), uint8_t(value)});
+}
+
+static void AppendChunk(std::vector<uint8_t>& png, std::string_view type, std::vector<uint8_t> const& data) {
+    AppendBigEndian32(png, data.size());
+    size_t start = png.size();
+    png.insert(png.end(), type.begin(), type.end());
+    png.insert(png.end(), data.begin(), data.end());
+    AppendBigEndian32(png, crc32(0, &png[start], png.size() - start));
+}
+
+static uint8_t Predict(uint8_t filter, uint8_t left, uint8_t up, uint8_t upLeft) {
+    switch (filter) {
+        case 1:
+            return left;
+        case 2:
+            return up;
+        case 3:
+            return (int(left) + up) / 2;
+        case 4: {
+            int p = int(left) + up - upLeft;
+            int pa = std::abs(p - left), pb = std::abs(p - up), pc = std::abs(p - upLeft);
+            return pa <= pb && pa <= pc ? left : pb <= pc ? up : upLeft;
+        }
+        default:
+            return 0;
+    }
+}
+
+/// @brief Encodes unfiltered scanlines as a PNG, each row with the next of the five filters, the data split over two IDATs.
+static std::vector<uint8_t> EncodePng(
+    uint32_t width, uint32_t height, uint8_t bitDepth, uint8_t colorType, std::vector<std::vector<uint8_t>> const& rows, std::vector<uint8_t> const& palette = {},
+    std::vector<uint8_t> const& paletteAlpha = {}
+) {
+    int channels = colorType == 2 ? 3 : colorType == 4 ? 2 : colorType == 6 ? 4 : 1;
+    size_t bytesPerPixel = std::max(1, channels * bitDepth / 8);
+
+    std::vector<uint8_t> filtered;
+    std::vector<uint8_t> previous(rows[0].size(), 0);
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t filter = y % 5;
+        filtered.push_back(filter);
+        for (size_t x = 0; x < rows[y].size(); x++) {
+            uint8_t left = x >= bytesPerPixel ? rows[y][x - bytesPerPixel] : 0;
+            uint8_t upLeft = x >= bytesPerPixel ? previous[x - bytesPerPixel] : 0;
+            filtered.push_back(rows[y][x] - Predict(filter, left, previous[x], upLeft));
+        }
+        previous = rows[y];
+    }
+
+    std::vector<uint8_t> compressed(compressBound(filtered.size()));
+    uLongf compressedSize = compressed.size();
+    EXPECT_EQ(compress(compressed.data(), &compressedSize, filtered.data(), filtered.size()), Z_OK);
+    compressed.resize(compressedSize);
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    std::vector<uint8_t> header;
+    AppendBigEndian32(header, width);
+    AppendBigEndian32(header, height);
+    header.insert(header.end(), {bitDepth, colorType, 0, 0, 0});
+    AppendChunk(png, "IHDR", header);
+    if (!palette.empty()) {
+        AppendChunk(png, "PLTE", palette);
+    }
+    if (!paletteAlpha.empty()) {
+        AppendChunk(png, "tRNS", paletteAlpha);
+    }
+    AppendChunk(png, "IDAT", {compressed.begin(), compressed.begin() + compressed.size() / 2});
+    AppendChunk(png, "IDAT", {compressed.begin() + compressed.size() / 2, compressed.end()});
+    AppendChunk(png, "IEND", {});
+    return png;
+}
+
+/// @brief Checks an 8-bit color type against random pixels, expanded to RGBA by hand.
+static void ExpectDecodes(uint8_t colorType) {
+    constexpr uint32_t width = 37;
+    constexpr uint32_t height = 23;
+    int channels = colorType == 2 ? 3 : colorType == 4 ? 2 : colorType == 6 ? 4 : 1;
+
+    std::mt19937 random(colorType);
+    std::vector<std::vector<uint8_t>> rows(height, std::vector<uint8_t>(width * channels));
+    std::vector<uint8_t> expected;
+    for (auto& row : rows) {
+        for (auto& value : row) {
+            value = random();
+        }
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t const* in = &row[x * channels];
+            switch (colorType) {
+                case 0:
+                    expected.insert(expected.end(), {in[0], in[0], in[0], 255});
+                    break;
+                case 2:
+                    expected.insert(expected.end(), {in[0], in[1], in[2], 255});
+                    break;
+                case 4:
+                    expected.insert(expected.end(), {in[0], in[0], in[0], in[1]});
+                    break;
+                case 6:
+                    expected.insert(expected.end(), {in[0], in[1], in[2], in[3]});
+                    break;
+            }
+        }
+    }
+
+    Image image = DecodePng(EncodePng(width, height, 8, colorType, rows));
+    EXPECT_EQ(image.width, width);
+    EXPECT_EQ(image.height, height);
+    EXPECT_EQ(image.pixels, expected);
+}
+
+TEST(PngDecoderTest, DecodesGrey) {
+    ExpectDecodes(0);
+}
+
+TEST(PngDecoderTest, DecodesRgb) {
+    ExpectDecodes(2);
+}
+
+TEST(PngDecoderTest, DecodesGreyAlpha) {
+    ExpectDecodes(4);
+}
+
+TEST(PngDecoderTest, DecodesRgba) {
+    ExpectDecodes(6);
+}
+
+TEST(PngDecoderTest, DecodesPackedPaletteWithTransparency) {
+    // 4-bit indices like assets/ModList/frame.png, with an odd width so the last byte of each row is half used
+    constexpr uint32_t width = 7;
+    constexpr uint32_t height = 6;
+    std::vector<uint8_t> palette;
+    for (int i = 0; i < 16; i++) {
+        palette.insert(palette.end(), {uint8_t(i * 16), uint8_t(255 - i), uint8_t(i * 3)});
+    }
+    std::vector<uint8_t> paletteAlpha = {0, 64, 128};
+
+    std::vector<std::vector<uint8_t>> rows(height, std::vector<uint8_t>((width + 1) / 2));
+    std::vector<uint8_t> expected;
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            uint8_t index = (x + y * 3) % 16;
+            rows[y][x / 2] |= x % 2 ? index : index << 4;
+            expected.insert(expected.end(), {palette[index * 3], palette[index * 3 + 1], palette[index * 3 + 2], index < 3 ? paletteAlpha[index] : uint8_t(255)});
+        }
+    }
+
+    Image image = DecodePng(EncodePng(width, height, 4, 3, rows, palette, paletteAlpha));
+    EXPECT_EQ(image.pixels, expected);
+}
+
+TEST(PngDecoderTest, RejectsUnsupportedImages) {
+    std::vector<std::vector<uint8_t>> rows(2, std::vector<uint8_t>(4));
+    EXPECT_THROW(DecodePng(EncodePng(2, 2, 16, 0, rows)), std::runtime_error);
+
+    std::vector<uint8_t> truncated = EncodePng(2, 2, 8, 0, {{1, 2}, {3, 4}});
+    truncated.resize(truncated.size() - 20);
+    EXPECT_THROW(DecodePng(truncated), std::runtime_error);
+    EXPECT_THROW(DecodePng(std::vector<uint8_t>{1, 2, 3}), std::runtime_error);
+}
+
+TEST(PngDecoderTest, RawTexturesAreBottomRowFirst) {
+    Image image{2, 2, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}};
+    std::vector<uint8_t> expected = {'R', 'T', 'E', 'X', 2, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0};
+    expected.insert(expected.end(), {9, 10, 11, 12, 13, 14, 15, 16, 1, 2, 3, 4, 5, 6, 7, 8});
+    EXPECT_EQ(EncodeRawTexture(image), expected);
+}
+
+TEST(PngDecoderTest, FrameIsOverThePredecodeLimit) {
+    // The default PREDECODE_MAX_BYTES of cmake/predecode-assets.cmake, the frame is embedded as PNG only
+    constexpr size_t maxBytes = 1048576;
+
+    std::string file = ReadFile(ASSETS_DIR "/ModList/frame.png");
+    Image image = DecodePng(std::span(reinterpret_cast<uint8_t const*>(file.data()), file.size()));
+    EXPECT_EQ(image.width, 3190);
+    EXPECT_EQ(image.height, 1492);
+    EXPECT_GT(image.pixels.size(), maxBytes);
+}
@@ -0,0 +1,243 @@
+#include <dlfcn.h>
+#include <gtest/gtest.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "elf_builder.hpp"
+#include "fmt/format.h"
+#include "integrity.hpp"
+#include "library_usage.hpp"
+#include "list_items.hpp"
+#include "scotland2/shared/modloader.h"
+#include "startup_cost.hpp"
+#include "test_utils.hpp"
+
+/// @brief Writes a library in the files dir, reported as loaded by the modloader stub.
+static std::string WriteLoadedLibrary(std::string_view relativePath, std::string_view id, std::string_view contents) {
+    // A deque, so the strings the stub points at never move
+    static std::deque<std::string> strings;
+
+    std::string path = fmt::format("{}/{}", modloader_get_files_dir(), relativePath);
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    WriteFile(path, contents);
+
+    CModResult mod{};
+    mod.info.id = strings.emplace_back(id).c_str();
+    mod.info.version = "1.0.0";
+    mod.path = strings.emplace_back(path).c_str();
+    ModloaderStub::loaded.push_back(mod);
+
+    CLoadResult result{};
+    result.result = MatchType_Loaded;
+    result.loaded = mod;
+    ModloaderStub::all.push_back(result);
+    return path;
+}
+
+/// @brief Waits for the background estimate, which has no wait function of its own.
+static std::optional<int> WaitForStartupCost(std::string const& path) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (auto cost = GetStartupCost(path)) {
+            return cost;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return std::nullopt;
+}
+
+TEST(StartupCostTest, CostsAndUsageComeFromTheIntegrityScan) {
+    ExpectInFreshProcess([] {
+        std::string cheap = WriteLoadedLibrary("mods/libcheap.so", "cheap", BuildElf({.needed = {"libused.so"}, .relocationCount = 10}));
+        std::string expensive = WriteLoadedLibrary(
+            "mods/libexpensive.so", "expensive", BuildElf({.relocationCount = 20000, .undefinedSymbolCount = 3000, .initArrayCount = 40})
+        );
+        WriteLoadedLibrary("libs/libused.so", "used", BuildElf({}));
+        WriteLoadedLibrary("libs/libunused.so", "unused", BuildElf({.relocationCount = 100}));
+
+        StartLibraryUsageAnalysis();
+        StartStartupCostEstimate();
+
+        EXPECT_EQ(WaitForStartupCost(expensive), 100);
+        auto cheapCost = WaitForStartupCost(cheap);
+        ASSERT_TRUE(cheapCost.has_value());
+        EXPECT_LT(*cheapCost, 10);
+
+        ASSERT_NE(GetUnusedLibrary("libunused.so"), nullptr);
+        EXPECT_EQ(GetUnusedLibrary("libunused.so")->relocationCount, 100);
+
+        // What removing the library saves uses the same cost model as the mods, on the same scale
+        UnusedLibrary const& unused = *GetUnusedLibrary("libunused.so");
+        auto unusedFile = MappedFile::Open(fmt::format("{}/libs/libunused.so", modloader_get_files_dir()));
+        auto expensiveFile = MappedFile::Open(expensive);
+        ASSERT_TRUE(unusedFile.has_value() && expensiveFile.has_value());
+        EXPECT_EQ(unused.startupCost, EstimateStartupCost(*ReadElfLibraryInfo(unusedFile->data())));
+        EXPECT_EQ(ScaleStartupCost(EstimateStartupCost(*ReadElfLibraryInfo(expensiveFile->data()))), 100);
+        auto scaled = ScaleStartupCost(unused.startupCost);
+        ASSERT_TRUE(scaled.has_value());
+        EXPECT_LT(*scaled, 100);
+        EXPECT_TRUE(DescribeUnusedLibrary(unused).ends_with(fmt::format(", with a startup cost of {} (the most expensive mod is 100)", *scaled)))
+            << DescribeUnusedLibrary(unused);
+        EXPECT_EQ(GetUnusedLibrary("libused.so"), nullptr);
+        ASSERT_NE(GetLibraryDependents("libused.so"), nullptr);
+        EXPECT_EQ(*GetLibraryDependents("libused.so"), std::vector<std::string>{"libcheap.so"});
+    });
+}
+
+TEST(StartupCostTest, AnalysesFinishEmptyWhenNoThreadCanStart) {
+    ExpectInFreshProcess([] {
+        std::string mod = WriteLoadedLibrary("mods/libmod.so", "mod", BuildElf({.needed = {"libused.so"}}));
+        WriteLoadedLibrary("libs/libunused.so", "unused", BuildElf({}));
+
+        // Leave too little address space for another thread stack, so every std::async and std::thread fails
+        size_t pages = 0;
+        std::ifstream("/proc/self/statm") >> pages;
+        rlim_t limit = pages * sysconf(_SC_PAGESIZE) + 4 * 1024 * 1024;
+        rlimit addressSpace{limit, limit};
+        ASSERT_EQ(setrlimit(RLIMIT_AS, &addressSpace), 0);
+
+        StartLibraryUsageAnalysis();
+        StartStartupCostEstimate();
+
+        EXPECT_TRUE(WaitForIntegrityScan(std::chrono::seconds(0)));
+        EXPECT_EQ(GetIntegrityIssue("mods", "libmod.so"), nullptr);
+        EXPECT_TRUE(IsLibraryUsageAnalysisDone());
+        EXPECT_EQ(GetUnusedLibrary("libunused.so"), nullptr);
+        EXPECT_EQ(GetLibraryDependents("libused.so"), nullptr);
+        EXPECT_EQ(GetStartupCost(mod), std::nullopt);
+        EXPECT_EQ(ScaleStartupCost(1), 0);
+    });
+}
+
+TEST(StartupCostTest, SortingFollowsTheSettingOnEveryCall) {
+    ExpectInFreshProcess([] {
+        std::string cheap = WriteLoadedLibrary("mods/libcheap.so", "cheap", BuildElf({.relocationCount = 10}));
+        std::string expensive = WriteLoadedLibrary("mods/libexpensive.so", "expensive", BuildElf({.relocationCount = 20000}));
+        StartStartupCostEstimate();
+        ASSERT_TRUE(WaitForStartupCost(expensive).has_value());
+
+        std::string modsPath = fmt::format("{}/mods", modloader_get_files_dir());
+        auto unsorted = GetLoadedModListItems(modloader_get_loaded(), modsPath, false);
+        ASSERT_EQ(unsorted.size(), 2);
+        EXPECT_TRUE(unsorted[0].content.starts_with("<color=green>cheap")) << unsorted[0].content;
+
+        auto sorted = GetLoadedModListItems(modloader_get_loaded(), modsPath, true);
+        ASSERT_EQ(sorted.size(), 2);
+        EXPECT_TRUE(sorted[0].content.starts_with("<color=#A0A0A0>100</color> <color=green>expensive")) << sorted[0].content;
+    });
+}
+
+/// @brief Ranks values, ties get the average of their ranks.
+static std::vector<double> Rank(std::vector<double> const& values) {
+    std::vector<size_t> order(values.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return values[a] < values[b];
+    });
+
+    std::vector<double> ranks(values.size());
+    for (size_t i = 0; i < order.size();) {
+        size_t end = i;
+        while (end + 1 < order.size() && values[order[end + 1]] == values[order[i]]) {
+            end++;
+        }
+        for (size_t j = i; j <= end; j++) {
+            ranks[order[j]] = (i + end) / 2.0;
+        }
+        i = end + 1;
+    }
+    return ranks;
+}
+
+static double SpearmanCorrelation(std::vector<double> const& a, std::vector<double> const& b) {
+    auto rankA = Rank(a);
+    auto rankB = Rank(b);
+    double meanA = std::accumulate(rankA.begin(), rankA.end(), 0.0) / rankA.size();
+    double meanB = std::accumulate(rankB.begin(), rankB.end(), 0.0) / rankB.size();
+
+    double covariance = 0, varianceA = 0, varianceB = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        covariance += (rankA[i] - meanA) * (rankB[i] - meanB);
+        varianceA += (rankA[i] - meanA) * (rankA[i] - meanA);
+        varianceB += (rankB[i] - meanB) * (rankB[i] - meanB);
+    }
+    return covariance / std::sqrt(varianceA * varianceB);
+}
+
+/// @brief The median time dlopen takes to load and relocate a library, in microseconds.
+static double MeasureLoadTime(std::string const& path) {
+    std::vector<double> times;
+    for (int run = 0; run < 25; run++) {
+        auto start = std::chrono::steady_clock::now();
+        void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_NE(handle, nullptr) << dlerror();
+        if (!handle) {
+            return 0;
+        }
+        dlclose(handle);
+
+        // The first runs fault the file into the page cache
+        if (run >= 3) {
+            times.push_back(elapsed);
+        }
+    }
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+TEST(StartupCostTest, EstimateRanksLibrariesLikeDlopen) {
+    // The libraries the estimate sees are loaded against the provider, like mods against their shared libraries
+    void* provider = dlopen(SYNTHETIC_LIBRARY_DIR "/libsynthetic_provider.so", RTLD_NOW | RTLD_GLOBAL);
+    ASSERT_NE(provider, nullptr) << dlerror();
+
+    std::vector<std::string> paths;
+    for (auto const& entry : std::filesystem::directory_iterator(SYNTHETIC_LIBRARY_DIR)) {
+        std::string filename = entry.path().filename().string();
+        if (filename.starts_with("libsynthetic_") && filename.ends_with(".so") && filename != "libsynthetic_provider.so") {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    ASSERT_GE(paths.size(), 10);
+
+    std::vector<double> estimates;
+    std::vector<double> loadTimes;
+    for (auto const& path : paths) {
+        auto file = MappedFile::Open(path);
+        ASSERT_TRUE(file.has_value()) << path;
+        auto info = ReadElfLibraryInfo(file->data());
+        ASSERT_TRUE(info.has_value()) << path;
+
+        estimates.push_back(EstimateStartupCost(*info));
+        loadTimes.push_back(MeasureLoadTime(path));
+        std::printf(
+            "%-28s %5llu relocations (%5llu relative) %5llu undefined %3llu constructors %6llu KiB mapped: estimate %7.1f, dlopen %8.1f us\n",
+            std::filesystem::path(path).filename().c_str(),
+            static_cast<unsigned long long>(info->relocationCount),
+            static_cast<unsigned long long>(info->relativeRelocationCount),
+            static_cast<unsigned long long>(info->undefinedSymbolCount),
+            static_cast<unsigned long long>(info->initArrayCount),
+            static_cast<unsigned long long>(info->mappedSize / 1024),
+            estimates.back(),
+            loadTimes.back()
+        );
+    }
+    dlclose(provider);
+
+    double correlation = SpearmanCorrelation(estimates, loadTimes);
+    std::printf("Spearman correlation between the estimate and dlopen time: %.3f\n", correlation);
+    RecordProperty("spearman", fmt::format("{:.3f}", correlation));
+    EXPECT_GE(correlation, 0.8);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Host stand-in for config-utils, values live in memory and start at their defaults.
+
+namespace ConfigUtils {
+template <typename T>
+struct ConfigValue {
+    T value;
+
+    T GetValue() const {
+        return value;
+    }
+    void SetValue(T newValue) {
+        value = newValue;
+    }
+};
+}  // namespace ConfigUtils
+
+#define DECLARE_CONFIG(name) \
+    struct name;             \
+    name& get##name();       \
+    struct name
+
+#define CONFIG_VALUE(name, type, jsonName, defaultValue, ...) ConfigUtils::ConfigValue<type> name{defaultValue}
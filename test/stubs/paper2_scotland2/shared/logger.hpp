@@ -0,0 +1,20 @@
+#pragma once
+
+// Host stand-in for the paper2 logger, the format strings are still checked but nothing is printed.
+
+#include "fmt/format.h"
+
+namespace Paper {
+struct ConstLoggerContext {
+    constexpr ConstLoggerContext(char const*) {}
+
+    template <typename... Args>
+    void debug(fmt::format_string<Args...>, Args&&...) const {}
+    template <typename... Args>
+    void info(fmt::format_string<Args...>, Args&&...) const {}
+    template <typename... Args>
+    void warn(fmt::format_string<Args...>, Args&&...) const {}
+    template <typename... Args>
+    void error(fmt::format_string<Args...>, Args&&...) const {}
+};
+}  // namespace Paper
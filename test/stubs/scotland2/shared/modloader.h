@@ -0,0 +1,66 @@
+#pragma once
+
+// Host stand-in for the scotland2 modloader API. Tests fill in ModloaderStub before the code under test reads it.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct CModInfo {
+    char const* id;
+    char const* version;
+    uint64_t version_long;
+};
+
+struct CModResult {
+    CModInfo info;
+    char const* path;
+    void* handle;
+};
+
+struct CModResults {
+    CModResult* array;
+    size_t size;
+};
+
+struct CFailedModResult {
+    char const* path;
+    char const* failure;
+};
+
+enum CLoadResultEnum {
+    MatchType_Loaded,
+    LoadResult_NotFound,
+    LoadResult_Failed,
+};
+
+struct CLoadResult {
+    CLoadResultEnum result;
+    union {
+        CModResult loaded;
+        CFailedModResult failed;
+    };
+};
+
+struct CLoadResults {
+    CLoadResult* array;
+    size_t size;
+};
+
+namespace ModloaderStub {
+/// @brief What modloader_get_loaded() reports.
+inline std::vector<CModResult> loaded;
+/// @brief What modloader_get_all() reports.
+inline std::vector<CLoadResult> all;
+}  // namespace ModloaderStub
+
+/// @brief A temporary directory, created on first use and removed when the test exits.
+char const* modloader_get_files_dir();
+
+inline CModResults modloader_get_loaded() {
+    return {ModloaderStub::loaded.data(), ModloaderStub::loaded.size()};
+}
+
+inline CLoadResults modloader_get_all() {
+    return {ModloaderStub::all.data(), ModloaderStub::all.size()};
+}
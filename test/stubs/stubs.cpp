@@ -0,0 +1,31 @@
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+#include "config.hpp"
+#include "scotland2/shared/modloader.h"
+
+Config& getConfig() {
+    static Config config;
+    return config;
+}
+
+char const* modloader_get_files_dir() {
+    // The files dir is inside its own temporary directory, since the log is looked up next to it in ../logs2
+    static std::filesystem::path root = []() {
+        std::string path = (std::filesystem::temp_directory_path() / "mod-list-test-XXXXXX").string();
+        if (!mkdtemp(path.data())) {
+            std::abort();
+        }
+        std::atexit([]() {
+            std::error_code error;
+            std::filesystem::remove_all(root, error);
+        });
+        return std::filesystem::path(path);
+    }();
+    static std::string filesDir = [&]() {
+        std::filesystem::create_directories(root / "files");
+        return (root / "files").string();
+    }();
+    return filesDir.c_str();
+}
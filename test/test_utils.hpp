@@ -0,0 +1,39 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+/// @brief Runs a test body in a fresh process, for code that keeps its state in statics (caches, background scans).
+/// The child re-executes the test binary, so it also gets its own modloader files dir.
+template <typename Body>
+void ExpectInFreshProcess(Body body) {
+#ifdef GTEST_FLAG_SET
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+#else
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+#endif
+    EXPECT_EXIT(
+        {
+            body();
+            std::exit(::testing::Test::HasFailure() ? 1 : 0);
+        },
+        ::testing::ExitedWithCode(0),
+        ""
+    );
+}
+
+/// @brief Writes a file, replacing it if it exists.
+inline void WriteFile(std::string const& path, std::string_view contents) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), contents.size());
+}
+
+/// @brief Reads a whole file, empty if it does not exist.
+inline std::string ReadFile(std::string const& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
@@ -0,0 +1,47 @@
+// Converts a PNG into a pre-decoded RGBA32 texture, see png_decoder.hpp for the layout.
+//
+// Usage: png2rgba <input.png> <output.rgba> [max pixel bytes]
+// Exits with 2 if the image would decode to more than the maximum, without writing anything.
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "png_decoder.hpp"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: %s <input.png> <output.rgba> [max pixel bytes]\n", argv[0]);
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!in.good() && !in.eof()) {
+        std::fprintf(stderr, "%s: failed to read\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<uint8_t> texture;
+    try {
+        Image image = DecodePng(file);
+        if (argc > 3 && image.pixels.size() > std::strtoull(argv[3], nullptr, 10)) {
+            std::fprintf(stderr, "%s: %ux%u decodes to %zu bytes, over the limit\n", argv[1], image.width, image.height, image.pixels.size());
+            return 2;
+        }
+        texture = EncodeRawTexture(image);
+    } catch (std::exception const& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[1], e.what());
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<char const*>(texture.data()), texture.size());
+    if (!out.good()) {
+        std::fprintf(stderr, "%s: failed to write\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include "png_decoder.hpp"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+static uint32_t ReadBigEndian32(uint8_t const* p) {
+    return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | uint32_t(p[3]);
+}
+
+static uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = int(a) + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+Image DecodePng(std::span<uint8_t const> file) {
+    static uint8_t const signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (file.size() < 8 || std::memcmp(file.data(), signature, 8) != 0) {
+        throw std::runtime_error("not a PNG file");
+    }
+
+    Image image;
+    uint8_t bitDepth = 0;
+    uint8_t colorType = 0;
+    std::vector<uint8_t> compressed;
+    std::vector<uint8_t> palette;
+    std::vector<uint8_t> paletteAlpha;
+
+    for (size_t offset = 8; offset + 12 <= file.size();) {
+        uint32_t length = ReadBigEndian32(&file[offset]);
+        if (offset + 12 + length > file.size()) {
+            throw std::runtime_error("truncated chunk");
+        }
+        std::string type(reinterpret_cast<char const*>(&file[offset + 4]), 4);
+        uint8_t const* data = &file[offset + 8];
+
+        if (type == "IHDR") {
+            image.width = ReadBigEndian32(data);
+            image.height = ReadBigEndian32(data + 4);
+            bitDepth = data[8];
+            colorType = data[9];
+            if (data[12] != 0) {
+                throw std::runtime_error("interlaced images are not supported");
+            }
+        } else if (type == "PLTE") {
+            palette.assign(data, data + length);
+        } else if (type == "tRNS") {
+            paletteAlpha.assign(data, data + length);
+        } else if (type == "IDAT") {
+            compressed.insert(compressed.end(), data, data + length);
+        } else if (type == "IEND") {
+            break;
+        }
+        offset += 12 + length;
+    }
+
+    int channels;
+    switch (colorType) {
+        case 0:
+            channels = 1;
+            break;
+        case 2:
+            channels = 3;
+            break;
+        case 3:
+            channels = 1;
+            break;
+        case 4:
+            channels = 2;
+            break;
+        case 6:
+            channels = 4;
+            break;
+        default:
+            throw std::runtime_error("unknown color type");
+    }
+    if (bitDepth != 8 && !(colorType == 3 && (bitDepth == 1 || bitDepth == 2 || bitDepth == 4))) {
+        throw std::runtime_error("only 8-bit images and palette images are supported");
+    }
+
+    size_t stride = (size_t(image.width) * channels * bitDepth + 7) / 8;
+    size_t bytesPerPixel = std::max<size_t>(1, channels * bitDepth / 8);
+    std::vector<uint8_t> raw((stride + 1) * image.height);
+    uLongf rawSize = raw.size();
+    if (uncompress(raw.data(), &rawSize, compressed.data(), compressed.size()) != Z_OK || rawSize != raw.size()) {
+        throw std::runtime_error("corrupted image data");
+    }
+
+    // Undo the per-row filters in place
+    std::vector<uint8_t> previous(stride, 0);
+    for (uint32_t y = 0; y < image.height; y++) {
+        uint8_t* row = &raw[y * (stride + 1) + 1];
+        uint8_t filter = row[-1];
+        for (size_t x = 0; x < stride; x++) {
+            uint8_t left = x >= bytesPerPixel ? row[x - bytesPerPixel] : 0;
+            uint8_t up = previous[x];
+            uint8_t upLeft = x >= bytesPerPixel ? previous[x - bytesPerPixel] : 0;
+            switch (filter) {
+                case 0:
+                    break;
+                case 1:
+                    row[x] += left;
+                    break;
+                case 2:
+                    row[x] += up;
+                    break;
+                case 3:
+                    row[x] += (int(left) + up) / 2;
+                    break;
+                case 4:
+                    row[x] += Paeth(left, up, upLeft);
+                    break;
+                default:
+                    throw std::runtime_error("unknown row filter");
+            }
+        }
+        std::memcpy(previous.data(), row, stride);
+    }
+
+    // Expand everything to RGBA
+    image.pixels.resize(size_t(image.width) * image.height * 4);
+    for (uint32_t y = 0; y < image.height; y++) {
+        uint8_t const* row = &raw[y * (stride + 1) + 1];
+        for (uint32_t x = 0; x < image.width; x++) {
+            uint8_t* out = &image.pixels[(size_t(y) * image.width + x) * 4];
+            switch (colorType) {
+                case 0:
+                    out[0] = out[1] = out[2] = row[x];
+                    out[3] = 255;
+                    break;
+                case 2:
+                    std::memcpy(out, &row[x * 3], 3);
+                    out[3] = 255;
+                    break;
+                case 3: {
+                    size_t bit = size_t(x) * bitDepth;
+                    uint8_t index = (row[bit / 8] >> (8 - bitDepth - bit % 8)) & ((1 << bitDepth) - 1);
+                    if (size_t(index) * 3 + 2 >= palette.size()) {
+                        throw std::runtime_error("palette index out of range");
+                    }
+                    std::memcpy(out, &palette[index * 3], 3);
+                    out[3] = index < paletteAlpha.size() ? paletteAlpha[index] : 255;
+                    break;
+                }
+                case 4:
+                    out[0] = out[1] = out[2] = row[x * 2];
+                    out[3] = row[x * 2 + 1];
+                    break;
+                case 6:
+                    std::memcpy(out, &row[x * 4], 4);
+                    break;
+            }
+        }
+    }
+
+    return image;
+}
+
+static void AppendLittleEndian32(std::vector<uint8_t>& out, uint32_t value) {
+    uint8_t bytes[4] = {uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)};
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+std::vector<uint8_t> EncodeRawTexture(Image const& image) {
+    std::vector<uint8_t> out = {'R', 'T', 'E', 'X'};
+    out.reserve(16 + image.pixels.size());
+    AppendLittleEndian32(out, image.width);
+    AppendLittleEndian32(out, image.height);
+    AppendLittleEndian32(out, 0);
+    for (uint32_t y = image.height; y-- > 0;) {
+        auto row = image.pixels.begin() + size_t(y) * image.width * 4;
+        out.insert(out.end(), row, row + size_t(image.width) * 4);
+    }
+    return out;
+}
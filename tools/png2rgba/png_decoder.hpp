@@ -0,0 +1,24 @@
+#pragma once
+
+// Decodes PNGs into pre-decoded RGBA32 textures, so they can be uploaded at runtime without decoding.
+//
+// Raw texture layout, all values little endian:
+//   char[4] "RTEX", uint32 width, uint32 height, uint32 format (0 = RGBA32)
+//   width * height * 4 bytes of pixels, bottom row first as Unity expects
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Image {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> pixels;  // RGBA, top row first
+};
+
+/// @brief Decodes a non-interlaced PNG: 8-bit grey, grey+alpha, RGB and RGBA, or 1/2/4/8-bit palette with tRNS.
+/// @throws std::runtime_error if the file is not a PNG or uses anything else.
+Image DecodePng(std::span<uint8_t const> file);
+
+/// @brief Encodes an image in the raw texture layout.
+std::vector<uint8_t> EncodeRawTexture(Image const& image);